@@ -3,7 +3,7 @@
 
 #include <stdio.h>
 
-#include "snesgen\Parser.h"
+#include "snesgen/Parser.h"
 
 static const char *EncodeIdentifier = "ENCODE_ASSET";
 
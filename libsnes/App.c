@@ -8,6 +8,7 @@
 #include "libutils/CheckedMemory.h"
 #include "libutils/Defs.h"
 #include "libutils/IncludeWindows.h"
+#include "libutils/Thread.h"
 
 #include <time.h>
 
@@ -41,10 +42,38 @@ typedef struct {
    Texture *snesTexture;
    ColorRGBA *snesBuffer;
 
+   //indexed rendering, the planes and cgram are resolved into snesFBO by snesPaletteShader
+   Shader *snesPaletteShader;
+   FBO *snesFBO;
+   Texture *snesIndexTexture, *snesFlagTexture, *snesPaletteTexture;
+   byte2 *snesIndices;
+   byte *snesFlags;
+   uint32_t snesPaletteGeneration;
+   StringView uSnesIndices, uSnesFlags, uSnesPalette;
+
    //testing
    Texture *logoImage;
 }RenderData;
 
+// The snes renders on its own thread from a published copy of App.snes so the next game step can run meanwhile
+// Only the render thread touches front and the snes output buffers while busy is set
+typedef struct {
+   Thread *thread;
+   Mutex *mutex;
+   Condition *cond;
+   SNES *front;
+   SNESRenderer *renderer; //every frame of front renders through it so unchanged lines and characters carry over
+
+   //the frame being rendered, copied from AppData when it's published
+   int renderFlags;
+   boolean indexed;
+
+   //how long the last frame took, the main thread hands it to the profiler since only it may touch that
+   Microseconds renderTime;
+
+   boolean busy, finished, quit; //finished is a rendered frame that hasn't been uploaded yet
+}SNESRenderThread;
+
 struct App_t {
    boolean running;
    Microseconds lastUpdated;
@@ -54,6 +83,7 @@ struct App_t {
    Window winData;
    RenderData rData;
    SNES snes;
+   SNESRenderThread snesThread;
    AppData data;
    FrameProfiler frameProfiler;
    DB_DBAssets *db;
@@ -101,10 +131,21 @@ static void _setupRenderData(App *app) {
    self->snesTexture = textureCreateCustom(SNES_SCANLINE_WIDTH, SNES_SCANLINE_COUNT, RepeatType_Clamp, FilterType_Linear);
    self->snesBuffer = checkedCalloc(SNES_SCANLINE_WIDTH * SNES_SCANLINE_COUNT, sizeof(ColorRGBA));
 
+   self->snesPaletteShader = shaderCreateFromBuffer(enc_Shader, ShaderParams_Color|ShaderParams_SnesPalette);
+   self->snesFBO = fboCreate((Int2) { SNES_SCANLINE_WIDTH, SNES_SCANLINE_COUNT }, RepeatType_Clamp, FilterType_Linear);
+   self->snesIndexTexture = textureCreateCustomFormat(SNES_SIZE_X, SNES_SIZE_Y, TextureFormat_R16UI, RepeatType_Clamp, FilterType_Nearest);
+   self->snesFlagTexture = textureCreateCustomFormat(SNES_SIZE_X, SNES_SIZE_Y, TextureFormat_R8UI, RepeatType_Clamp, FilterType_Nearest);
+   self->snesPaletteTexture = textureCreateCustomFormat(256, 1, TextureFormat_R16UI, RepeatType_Clamp, FilterType_Nearest);
+   self->snesIndices = checkedCalloc(SNES_SIZE_X * SNES_SIZE_Y, sizeof(byte2));
+   self->snesFlags = checkedCalloc(SNES_SIZE_X * SNES_SIZE_Y, sizeof(byte));
+
    self->uModel = stringIntern("uModelMatrix");
    self->uColor = stringIntern("uColorTransform");
    self->uTexture = stringIntern("uTexMatrix");
    self->uTextureSlot = stringIntern("uTexture");
+   self->uSnesIndices = stringIntern("uSnesIndices");
+   self->uSnesFlags = stringIntern("uSnesFlags");
+   self->uSnesPalette = stringIntern("uSnesPalette");
 }
 
 static void _renderDataDestroy(RenderData *self) {
@@ -117,10 +158,80 @@ static void _renderDataDestroy(RenderData *self) {
    textureDestroy(self->snesTexture);
    checkedFree(self->snesBuffer);
 
+   shaderDestroy(self->snesPaletteShader);
+   fboDestroy(self->snesFBO);
+   textureDestroy(self->snesIndexTexture);
+   textureDestroy(self->snesFlagTexture);
+   textureDestroy(self->snesPaletteTexture);
+   checkedFree(self->snesIndices);
+   checkedFree(self->snesFlags);
+
    textureManagerDestroy(self->textureManager);
 }
 
 
+static int _snesRenderThreadFunc(void *data) {
+   App *self = (App*)data;
+   SNESRenderThread *rt = &self->snesThread;
+
+   mutexLock(rt->mutex);
+   while (true) {
+      while (!rt->busy && !rt->quit) {
+         conditionWait(rt->cond, rt->mutex);
+      }
+      if (rt->quit) {
+         break;
+      }
+      mutexUnlock(rt->mutex);
+
+      Microseconds start = appGetTime(self);
+
+      if (rt->indexed) {
+         snesRenderIndexed(rt->front, rt->renderer, self->rData.snesIndices, self->rData.snesFlags, rt->renderFlags);
+      }
+      else {
+         snesRender(rt->front, rt->renderer, self->rData.snesBuffer, rt->renderFlags);
+      }
+
+      Microseconds end = appGetTime(self);
+
+      mutexLock(rt->mutex);
+      rt->renderTime = end - start;
+      rt->busy = false;
+      rt->finished = true;
+      conditionBroadcast(rt->cond);
+   }
+   mutexUnlock(rt->mutex);
+
+   return 0;
+}
+
+static void _snesRenderThreadStart(App *self) {
+   SNESRenderThread *rt = &self->snesThread;
+
+   rt->front = checkedCalloc(1, sizeof(SNES));
+   rt->renderer = snesRendererCreate();
+   rt->mutex = mutexCreate();
+   rt->cond = conditionCreate();
+   rt->thread = threadCreate(&_snesRenderThreadFunc, self);
+}
+
+static void _snesRenderThreadStop(App *self) {
+   SNESRenderThread *rt = &self->snesThread;
+
+   mutexLock(rt->mutex);
+   rt->quit = true;
+   conditionBroadcast(rt->cond);
+   mutexUnlock(rt->mutex);
+   threadJoin(rt->thread);
+
+   conditionDestroy(rt->cond);
+   mutexDestroy(rt->mutex);
+   checkedFree(rt->front);
+   snesRendererDestroy(rt->renderer);
+}
+
+
 App *appCreate(Renderer *renderer, DeviceContext *context) {
    App *out = checkedCalloc(1, sizeof(App));
    g_App = out;
@@ -136,9 +247,14 @@ App *appCreate(Renderer *renderer, DeviceContext *context) {
    out->data.log = out->log;
    out->data.snes = &out->snes;
    out->data.snesTex = out->rData.snesTexture;
+   out->data.snesFBO = out->rData.snesFBO;
+   out->data.snesRenderIndexed = CONFIG_SNES_RENDER_INDEXED;
+   out->data.snesRenderPipelined = CONFIG_SNES_RENDER_PIPELINED;
 
    out->data.textureManager = out->rData.textureManager;
    out->data.frameProfiler = &out->frameProfiler;
+   out->data.snesRenderThreads = CONFIG_SNES_RENDER_THREADS;
+   _snesRenderThreadStart(out);
 
    (Window*)out->data.window = &out->winData;
 
@@ -155,6 +271,8 @@ App *appCreate(Renderer *renderer, DeviceContext *context) {
 }
 void appDestroy(App *self) {
    gameDestroy(self->game);
+   _snesRenderThreadStop(self);
+   snesRenderSetThreadCount(0);
 
    _renderDataDestroy(&self->rData);
    db_DBAssetsDestroy(self->db);
@@ -242,7 +360,10 @@ static void _renderBasicRectModel(App *self, Texture *tex, Float2 pos, Float2 si
    matrixIdentity(&texMatrix);
    r_setMatrix(r, self->rData.uTexture, &texMatrix);
 
-   r_bindTexture(r, tex, 0);
+   //NULL draws whatever is already bound to slot 0
+   if (tex) {
+      r_bindTexture(r, tex, 0);
+   }
    r_setTextureSlot(r, self->rData.uTextureSlot, 0);
 
    r_renderModel(r, self->rData.rectModel, ModelRenderType_Triangles);
@@ -254,18 +375,74 @@ static void _gameStep(App *self) {
    frameProfilerEndEntry(&self->frameProfiler, PROFILE_GAME_UPDATE);
 }
 
+static void _snesRenderWait(App *self) {
+   SNESRenderThread *rt = &self->snesThread;
+
+   mutexLock(rt->mutex);
+   while (rt->busy) {
+      conditionWait(rt->cond, rt->mutex);
+   }
+   mutexUnlock(rt->mutex);
+}
+
+// copies the last finished frame into the snes textures, the render thread must be idle
+static void _snesUploadFrame(App *self) {
+   SNESRenderThread *rt = &self->snesThread;
+
+   //unchanged scanlines are skipped by the render, only upload the rows it wrote
+   SNESLineCache *lines = &rt->renderer->lineCache;
+
+   if (!rt->finished) {
+      return;
+   }
+   rt->finished = false;
+
+   frameProfilerSetEntry(&self->frameProfiler, PROFILE_SNES_RENDER, rt->renderTime);
+
+   self->data.snesFrameIndexed = rt->indexed;
+   if (rt->indexed) {
+      textureSetPixelRows(self->rData.snesIndexTexture, (byte*)self->rData.snesIndices, lines->dirtyTop, lines->dirtyBottom - lines->dirtyTop);
+      textureSetPixelRows(self->rData.snesFlagTexture, self->rData.snesFlags, lines->dirtyTop, lines->dirtyBottom - lines->dirtyTop);
+
+      //the render brought the palette cache up to date, only re-upload cgram if it changed
+      if (rt->renderer->paletteCache.generation != self->rData.snesPaletteGeneration) {
+         textureSetPixels(self->rData.snesPaletteTexture, (byte*)&rt->front->cgram);
+         self->rData.snesPaletteGeneration = rt->renderer->paletteCache.generation;
+      }
+   }
+   else {
+      textureSetPixelRows(self->rData.snesTexture, (byte*)self->rData.snesBuffer, lines->dirtyTop, lines->dirtyBottom - lines->dirtyTop);
+   }
+}
+
 static void _snesSoftwareRender(App *self) {
-   frameProfilerStartEntry(&self->frameProfiler, PROFILE_SNES_RENDER);
-   Renderer *r = self->renderer;
+   SNESRenderThread *rt = &self->snesThread;
+
+   //the frame published last step is what gets shown this step
+   _snesRenderWait(self);
+   _snesUploadFrame(self);
 
-   int renderFlags = 0;
-   if (self->data.snesRenderWhite) {
-      renderFlags |= SNES_RENDER_DEBUG_WHITE;
+   //the band workers are only resized while the render thread is idle, and from here because
+   //creating them allocates, which isn't safe to do alongside the main thread
+   if (self->data.snesRenderThreads != snesRenderGetThreadCount()) {
+      snesRenderSetThreadCount(self->data.snesRenderThreads);
    }
 
-   snesRender(&self->snes, self->rData.snesBuffer, renderFlags);
-   textureSetPixels(self->rData.snesTexture, (byte*)self->rData.snesBuffer);
-   frameProfilerEndEntry(&self->frameProfiler, PROFILE_SNES_RENDER);
+   //front is only PPU state, the renderer works out for itself what changed since the last frame
+   *rt->front = self->snes;
+
+   mutexLock(rt->mutex);
+   rt->renderFlags = self->data.snesRenderWhite ? SNES_RENDER_DEBUG_WHITE : 0;
+   rt->indexed = self->data.snesRenderIndexed && !snesNeedsDirectColor(rt->front);
+   rt->busy = true;
+   conditionBroadcast(rt->cond);
+   mutexUnlock(rt->mutex);
+
+   //without pipelining the new frame is shown right away
+   if (!self->data.snesRenderPipelined) {
+      _snesRenderWait(self);
+      _snesUploadFrame(self);
+   }
 }
 
 static void _renderGUI(App *self) {
@@ -290,9 +467,49 @@ static void _renderGUI(App *self) {
    frameProfilerEndEntry(&self->frameProfiler, PROFILE_GUI_UPDATE);
 }
 
+//draws the indexed snes frame into snesFBO at the same size and layout snesRender outputs
+static void _resolveSnesPalette(App *self) {
+   Renderer *r = self->renderer;
+   FBO *fbo = self->rData.snesFBO;
+   Int2 size = fboGetSize(fbo);
+   const Recti vp = { 0, 0, size.x, size.y };
+
+   r_bindFBOToWrite(r, fbo);
+   r_viewport(r, &vp);
+   r_enableAlphaBlending(r, false);
+
+   UBOMain ubo = { 0 };
+   matrixIdentity(&ubo.view);
+   matrixOrtho(&ubo.view, 0.0f, (float)size.x, (float)size.y, 0.0f, 1.0f, -1.0f);
+   r_setUBOData(r, self->rData.ubo, ubo);
+
+   r_setShader(r, self->rData.snesPaletteShader);
+
+   Matrix model = { 0 };
+   matrixIdentity(&model);
+   matrixScale(&model, (Float2) { (float)size.x, (float)size.y });
+   r_setMatrix(r, self->rData.uModel, &model);
+   r_setColor(r, self->rData.uColor, &White);
+
+   r_bindTexture(r, self->rData.snesIndexTexture, 0);
+   r_bindTexture(r, self->rData.snesFlagTexture, 1);
+   r_bindTexture(r, self->rData.snesPaletteTexture, 2);
+   r_setTextureSlot(r, self->rData.uSnesIndices, 0);
+   r_setTextureSlot(r, self->rData.uSnesFlags, 1);
+   r_setTextureSlot(r, self->rData.uSnesPalette, 2);
+
+   r_renderModel(r, self->rData.rectModel, ModelRenderType_Triangles);
+
+   r_bindFBOToWrite(r, NULL);
+}
+
 static void _renderStep(App *self) {
    frameProfilerStartEntry(&self->frameProfiler, PROFILE_RENDER);
 
+   if (self->data.snesFrameIndexed) {
+      _resolveSnesPalette(self);
+   }
+
 
    //test render because maybe screw the fbo??
    Renderer *r = self->renderer;
@@ -320,7 +537,13 @@ static void _renderStep(App *self) {
       size.x = (float)winSize.x;
       size.y = (size.x * 9.0f) / 16.0f;
 
-      _renderBasicRectModel(self, self->rData.snesTexture, (Float2) { 0.0f, 0.0f }, size, White);
+      if (self->data.snesFrameIndexed) {
+         r_bindFBOToRender(r, self->rData.snesFBO, 0);
+         _renderBasicRectModel(self, NULL, (Float2) { 0.0f, 0.0f }, size, White);
+      }
+      else {
+         _renderBasicRectModel(self, self->rData.snesTexture, (Float2) { 0.0f, 0.0f }, size, White);
+      }
    }
 
    r_finish(r);
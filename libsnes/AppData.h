@@ -6,6 +6,7 @@
 typedef struct SNES_t SNES;
 typedef struct TextureManager_t TextureManager;
 typedef struct Texture_t Texture;
+typedef struct FBO_t FBO;
 typedef struct FrameProfiler_t FrameProfiler;
 typedef struct LogSpud_t LogSpud;
 typedef struct DB_DBAssets DB_DBAssets;
@@ -33,7 +34,12 @@ typedef struct AppData_t {
    const Window *window;
    Variables variables;
    Texture *snesTex;
+   FBO *snesFBO; //holds the frame instead of snesTex when snesFrameIndexed is set
    int testX, testY, testBGX, testBGY, testMosaic;
    int snesRenderWhite;
+   int snesRenderThreads;
+   int snesRenderIndexed;
+   int snesRenderPipelined;
+   boolean snesFrameIndexed; //the frame on screen was rendered indexed, direct color frames aren't even with snesRenderIndexed set
    boolean guiEnabled;
 }AppData;
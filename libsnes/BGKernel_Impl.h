@@ -0,0 +1,182 @@
+// The BG scanline rasterizer every kernel in snes.c's BG_KERNEL_LIST is built from, included once by snes.c.
+// Each kernel first fetches the scanline's tile row into BGTileColumns, using each column's scroll
+// so offset-per-tile costs nothing extra, then fills the line from those.
+// The kernels pass these as constants and this is always inlined into them, so every test on
+// them below folds away and each kernel only carries the paths it takes:
+//    depth: 2, 4 or 8, bits per pixel of the characters
+//    tSize: 0 for 8x8 tiles, 1 for 16x16
+//    mosaic: 1 if the layer is mosaic'd with a block bigger than a pixel
+//    hires: 1 for modes 5 and 6, tiles are 16 hires pixels wide and the odd pixels go to the
+//       main screen lines while the even ones go to the sub screen lines
+
+// Rasterizes one BG scanline into one buffer per tile priority, hires also fills the sub screen's pair
+// every pixel of the buffers it fills is written so the caller never needs to clear them
+static SNES_FORCE_INLINE void _rasterizeBGKernel(SNES *self, const SNESTileCache *cache, const Registers *r, ProcessBG *l, const BGColumnScroll *scroll, int y, byte mosaicSize, byte2 *lines[4],
+   int depth, int tSize, int mosaic, int hires) {
+
+   const byte (*chars)[8 * 8] = depth == 2 ? cache->color4s : depth == 4 ? cache->color16s : cache->color256s;
+   size_t charSize = depth == 2 ? sizeof(Char4) : depth == 4 ? sizeof(Char16) : sizeof(Char256);
+   byte2 charMask = (depth == 2 ? SNES_VRAM_CHAR4_COUNT : depth == 4 ? SNES_VRAM_CHAR16_COUNT : SNES_VRAM_CHAR256_COUNT) - 1;
+   byte tShift = tSize ? 4 : 3, tMask = tSize ? 15 : 7;
+
+   //a hires column is a whole 16 pixel wide tile, which covers 8 low res pixels just like a character column
+   byte colShift = hires ? 4 : 3, txShift = hires ? 4 : tShift;
+
+   TileMap *tMapBase = (TileMap*)(self->vram.raw + (l->baseAddr << 11));
+   byte2 charBase = (byte2)((l->charBase << 13) / charSize);
+   BGTileColumn columns[BG_TILE_COLUMNS];
+   int x = 0, i = 0, col = 0;
+
+   //256 color characters index cgram directly, direct color turns the palette bits into the low bit of each channel
+   boolean direct = depth == 8 && r->colorMathControl.directColorMode;
+
+   int lineY = mosaic ? y - y % (mosaicSize + 1) : y;
+
+   //resolve every character column the scanline touches once, the pixel loops below only index into these
+   for (col = 0; col < BG_TILE_COLUMNS; ++col) {
+      BGTileColumn *out = columns + col;
+      int colX = ((scroll->horz[col] >> 3) + col) << colShift;
+      int bgY = lineY + scroll->vert[col];
+
+      //depending on how many tile maps are given to the BG, either point at a different map or wrap around
+      TileMap *tMap = tMapBase;
+      byte tileY = (byte)(bgY >> tShift);
+      tileY &= l->sizeY ? 63 : 31;
+      if (tileY >= 32) {
+         tileY &= 31; tMap += l->sizeX ? 2 : 1;
+      }
+
+      byte inTileY = (byte)(bgY & tMask);
+      byte tileX = (byte)(colX >> txShift);
+      tileX &= l->sizeX ? 63 : 31;
+      if (tileX >= 32) {
+         tileX &= 31; tMap += 1;
+      }
+
+      Tile *t = tMap->tiles + (tileY * 32 + tileX);
+      out->priority = t->tile.priority;
+
+      if (!t->tile.character) {
+         out->palette = 0;
+         memset(out->pixels, 0, sizeof(out->pixels));
+         continue;
+      }
+
+      byte rowY = t->tile.flipY ? tMask - inTileY : inTileY;
+      byte2 c = charBase + t->tile.character;
+
+      //16x16 tiles are 4 characters, the bottom two sit 16 characters after the top
+      if (tSize && rowY >= 8) {
+         rowY -= 8;
+         c += 16;
+      }
+
+      if (depth == 8) {
+         out->palette = direct ? LINE_DIRECT | (t->tile.palette << 8) : 0;
+      }
+      else {
+         out->palette = t->tile.palette * 16;
+      }
+
+      if (hires) {
+         //the tile's row is both of its characters side by side, split here into the main screen's odd pixels
+         //and the sub screen's even ones so the line loops below store them in pairs
+         byte row[16];
+         memcpy(row, chars[c & charMask] + rowY * 8, 8);
+         memcpy(row + 8, chars[(c + 1) & charMask] + rowY * 8, 8);
+
+         if (t->tile.flipX) {
+            for (i = 0; i < 8; ++i) {
+               out->pixels[0][i] = row[14 - i * 2];
+               out->pixels[1][i] = row[15 - i * 2];
+            }
+         }
+         else {
+            for (i = 0; i < 8; ++i) {
+               out->pixels[0][i] = row[i * 2 + 1];
+               out->pixels[1][i] = row[i * 2];
+            }
+         }
+      }
+      else {
+         //flipping mirrors the whole tile so the halves swap too
+         if (tSize) {
+            c += (byte)((colX >> 3) & 1) ^ t->tile.flipX;
+         }
+         const byte *row = chars[c & charMask] + rowY * 8;
+
+         if (t->tile.flipX) {
+            for (i = 0; i < 8; ++i) {
+               out->pixels[0][i] = row[7 - i];
+            }
+         }
+         else {
+            memcpy(out->pixels[0], row, 8);
+         }
+      }
+   }
+
+   if (mosaic) {
+      //mosaic'd layers step a block at a time, the block's first pixel is looked up once and filled across it
+      for (x = 0; x < SNES_SIZE_X; x += mosaicSize + 1) {
+         int blockX = x + (l->horzOffset & 7);
+         int count = MIN(mosaicSize + 1, SNES_SIZE_X - x);
+         BGTileColumn *column = columns + (blockX >> 3);
+         byte pixel = column->pixels[0][blockX & 7];
+         byte2 value = pixel ? column->palette + pixel : 0;
+         byte2 *dest = lines[column->priority] + x;
+         byte2 *other = lines[!column->priority] + x;
+
+         if (hires) {
+            byte subPixel = column->pixels[1][blockX & 7];
+            byte2 subValue = subPixel ? column->palette + subPixel : 0;
+            byte2 *subDest = lines[2 + column->priority] + x;
+            byte2 *subOther = lines[2 + !column->priority] + x;
+
+            for (i = 0; i < count; ++i) {
+               dest[i] = value;
+               subDest[i] = subValue;
+               other[i] = subOther[i] = 0;
+            }
+         }
+         else {
+            for (i = 0; i < count; ++i) {
+               dest[i] = value;
+               other[i] = 0;
+            }
+         }
+      }
+   }
+   else {
+      //run a character column at a time, only the first one can start part way in
+      col = 0;
+      while (x < SNES_SIZE_X) {
+         BGTileColumn *column = columns + col++;
+         byte inColX = (byte)((x + l->horzOffset) & 7);
+         int count = MIN(8 - inColX, SNES_SIZE_X - x);
+         const byte *pixels = column->pixels[0] + inColX;
+         byte2 *dest = lines[column->priority] + x;
+         byte2 *other = lines[!column->priority] + x;
+
+         if (hires) {
+            const byte *subPixels = column->pixels[1] + inColX;
+            byte2 *subDest = lines[2 + column->priority] + x;
+            byte2 *subOther = lines[2 + !column->priority] + x;
+
+            for (i = 0; i < count; ++i) {
+               dest[i] = pixels[i] ? column->palette + pixels[i] : 0;
+               subDest[i] = subPixels[i] ? column->palette + subPixels[i] : 0;
+               other[i] = subOther[i] = 0;
+            }
+         }
+         else {
+            for (i = 0; i < count; ++i) {
+               dest[i] = pixels[i] ? column->palette + pixels[i] : 0;
+               other[i] = 0;
+            }
+         }
+
+         x += count;
+      }
+   }
+}
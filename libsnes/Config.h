@@ -12,5 +12,10 @@
 #define CONFIG_WINDOW_FRAMERATE 60 //-1 unlimited
 #define CONFIG_WINDOW_TITLE "SNESQuest: Edge of Sorrow"
 
+//snes renderer options
+#define CONFIG_SNES_RENDER_THREADS 4 //total threads snesRender splits each frame across, 1 renders serially
+#define CONFIG_SNES_RENDER_INDEXED 1 //render cgram indices and resolve colors on the gpu
+#define CONFIG_SNES_RENDER_PIPELINED 1 //render each frame on its own thread during the next game step, shown a frame late
+
 
 
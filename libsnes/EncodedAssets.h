@@ -67,30 +67,79 @@ static const byte enc_Shader[] = ENCODE_ASSET("EncodedAssets/shaders.glsl",
    0x52, 0x41, 0x47, 0x4D, 0x45, 0x4E, 0x54, 0x0D, 0x0A, 0x0D, 0x0A, 0x6F, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x6F, 0x75, 0x74, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0D, 0x0A, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x76, 0x43, 
    0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0D, 0x0A, 0x0D, 0x0A, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x44, 0x49, 0x46, 0x46, 0x55, 0x53, 0x45, 0x5F, 0x54, 0x45, 0x58, 0x54, 0x55, 0x52, 0x45, 0x0D, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 
    0x73, 0x61, 0x6D, 0x70, 0x6C, 0x65, 0x72, 0x32, 0x44, 0x20, 0x75, 0x54, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x3B, 0x0D, 0x0A, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x76, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x73, 0x3B, 0x0D, 
-   0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x0D, 0x0A, 0x76, 0x6F, 0x69, 0x64, 0x20, 0x6D, 0x61, 0x69, 0x6E, 0x28, 0x29, 0x7B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 
-   0x76, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0D, 0x0A, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x44, 0x49, 0x46, 0x46, 0x55, 0x53, 0x45, 0x5F, 0x54, 0x45, 0x58, 0x54, 0x55, 0x52, 0x45, 0x0D, 0x0A, 0x20, 0x20, 0x20, 
-   0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x2A, 0x3D, 0x20, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x28, 0x75, 0x54, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x2C, 0x20, 0x76, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x73, 0x29, 0x3B, 0x0D, 0x0A, 
-   0x20, 0x20, 0x20, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x6F, 0x75, 0x74, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0D, 0x0A, 
-   0x7D, 0x0D, 0x0A, 0x0D, 0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x0D, 0x0A, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x56, 0x45, 0x52, 0x54, 0x45, 0x58, 0x0D, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x6D, 0x61, 0x74, 
-   0x34, 0x20, 0x75, 0x4D, 0x6F, 0x64, 0x65, 0x6C, 0x4D, 0x61, 0x74, 0x72, 0x69, 0x78, 0x3B, 0x0D, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x75, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x54, 0x72, 0x61, 0x6E, 0x73, 
-   0x66, 0x6F, 0x72, 0x6D, 0x3B, 0x0D, 0x0A, 0x0D, 0x0A, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x52, 0x4F, 0x54, 0x41, 0x54, 0x49, 0x4F, 0x4E, 0x0D, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x6D, 0x61, 0x74, 0x34, 0x20, 0x75, 0x4D, 
-   0x6F, 0x64, 0x65, 0x6C, 0x52, 0x6F, 0x74, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x3B, 0x0D, 0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x0D, 0x0A, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x61, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 
-   0x6E, 0x3B, 0x0D, 0x0A, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x43, 0x4F, 0x4C, 0x4F, 0x52, 0x5F, 0x41, 0x54, 0x54, 0x52, 0x49, 0x42, 0x55, 0x54, 0x45, 0x0D, 0x0A, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x61, 0x43, 0x6F, 0x6C, 0x6F, 
-   0x72, 0x3B, 0x0D, 0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x6F, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x76, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0D, 0x0A, 0x0D, 0x0A, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x44, 0x49, 
-   0x46, 0x46, 0x55, 0x53, 0x45, 0x5F, 0x54, 0x45, 0x58, 0x54, 0x55, 0x52, 0x45, 0x0D, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x6D, 0x61, 0x74, 0x34, 0x20, 0x75, 0x54, 0x65, 0x78, 0x4D, 0x61, 0x74, 0x72, 0x69, 0x78, 0x3B, 0x0D, 0x0A, 
-   0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x61, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x73, 0x3B, 0x0D, 0x0A, 0x6F, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x76, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x73, 0x3B, 
-   0x0D, 0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x0D, 0x0A, 0x76, 0x6F, 0x69, 0x64, 0x20, 0x6D, 0x61, 0x69, 0x6E, 0x28, 0x29, 0x20, 0x7B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x43, 0x4F, 0x4C, 0x4F, 
-   0x52, 0x5F, 0x41, 0x54, 0x54, 0x52, 0x49, 0x42, 0x55, 0x54, 0x45, 0x0D, 0x0A, 0x09, 0x76, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x61, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x2A, 0x20, 0x75, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x54, 0x72, 0x61, 
-   0x6E, 0x73, 0x66, 0x6F, 0x72, 0x6D, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x65, 0x6C, 0x73, 0x65, 0x0D, 0x0A, 0x09, 0x76, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x75, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x54, 0x72, 0x61, 0x6E, 0x73, 0x66, 
-   0x6F, 0x72, 0x6D, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x44, 0x49, 0x46, 0x46, 0x55, 0x53, 
-   0x45, 0x5F, 0x54, 0x45, 0x58, 0x54, 0x55, 0x52, 0x45, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x20, 0x3D, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x61, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 
-   0x73, 0x2C, 0x20, 0x30, 0x2E, 0x30, 0x2C, 0x20, 0x31, 0x2E, 0x30, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x20, 0x3D, 0x20, 0x75, 0x54, 0x65, 0x78, 0x4D, 0x61, 0x74, 0x72, 0x69, 0x78, 0x20, 0x2A, 0x20, 0x63, 0x6F, 
-   0x6F, 0x72, 0x64, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x76, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x73, 0x20, 0x3D, 0x20, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x2E, 0x78, 0x79, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x65, 0x6E, 0x64, 0x69, 
-   0x66, 0x0D, 0x0A, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x70, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x61, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x2C, 0x20, 0x30, 
-   0x2C, 0x20, 0x31, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x6D, 0x61, 0x74, 0x34, 0x20, 0x6D, 0x6F, 0x64, 0x65, 0x6C, 0x20, 0x3D, 0x20, 0x75, 0x4D, 0x6F, 0x64, 0x65, 0x6C, 0x4D, 0x61, 0x74, 0x72, 0x69, 0x78, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 
-   0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x52, 0x4F, 0x54, 0x41, 0x54, 0x49, 0x4F, 0x4E, 0x0D, 0x0A, 0x09, 0x6D, 0x6F, 0x64, 0x65, 0x6C, 0x20, 0x2A, 0x3D, 0x20, 0x75, 0x4D, 0x6F, 0x64, 0x65, 0x6C, 0x52, 0x6F, 0x74, 0x61, 0x74, 0x69, 0x6F, 0x6E, 
-   0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x09, 0x20, 0x20, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x67, 0x6C, 0x5F, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x75, 0x56, 0x69, 0x65, 0x77, 
-   0x4D, 0x61, 0x74, 0x72, 0x69, 0x78, 0x20, 0x2A, 0x20, 0x28, 0x6D, 0x6F, 0x64, 0x65, 0x6C, 0x20, 0x2A, 0x20, 0x70, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x67, 0x6C, 0x5F, 0x50, 0x6F, 0x73, 
-   0x69, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x70, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x3B, 0x0D, 0x0A, 0x7D, 0x0D, 0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x00);
+   0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x0D, 0x0A, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x53, 0x4E, 0x45, 0x53, 0x5F, 0x50, 0x41, 0x4C, 0x45, 0x54, 0x54, 0x45, 0x0D, 0x0A, 0x2F, 0x2F, 0x72, 0x65, 0x73, 0x6F, 0x6C, 0x76, 0x65, 
+   0x73, 0x20, 0x74, 0x68, 0x65, 0x20, 0x70, 0x6C, 0x61, 0x6E, 0x65, 0x73, 0x20, 0x66, 0x72, 0x6F, 0x6D, 0x20, 0x73, 0x6E, 0x65, 0x73, 0x52, 0x65, 0x6E, 0x64, 0x65, 0x72, 0x49, 0x6E, 0x64, 0x65, 0x78, 0x65, 0x64, 0x20, 0x61, 0x67, 0x61, 0x69, 0x6E, 
+   0x73, 0x74, 0x20, 0x63, 0x67, 0x72, 0x61, 0x6D, 0x2C, 0x20, 0x6D, 0x75, 0x73, 0x74, 0x20, 0x6D, 0x61, 0x74, 0x63, 0x68, 0x20, 0x73, 0x6E, 0x65, 0x73, 0x52, 0x65, 0x6E, 0x64, 0x65, 0x72, 0x20, 0x65, 0x78, 0x61, 0x63, 0x74, 0x6C, 0x79, 0x0D, 0x0A, 
+   0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x75, 0x73, 0x61, 0x6D, 0x70, 0x6C, 0x65, 0x72, 0x32, 0x44, 0x20, 0x75, 0x53, 0x6E, 0x65, 0x73, 0x49, 0x6E, 0x64, 0x69, 0x63, 0x65, 0x73, 0x3B, 0x0D, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 
+   0x20, 0x75, 0x73, 0x61, 0x6D, 0x70, 0x6C, 0x65, 0x72, 0x32, 0x44, 0x20, 0x75, 0x53, 0x6E, 0x65, 0x73, 0x46, 0x6C, 0x61, 0x67, 0x73, 0x3B, 0x0D, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x75, 0x73, 0x61, 0x6D, 0x70, 0x6C, 0x65, 0x72, 
+   0x32, 0x44, 0x20, 0x75, 0x53, 0x6E, 0x65, 0x73, 0x50, 0x61, 0x6C, 0x65, 0x74, 0x74, 0x65, 0x3B, 0x0D, 0x0A, 0x0D, 0x0A, 0x75, 0x76, 0x65, 0x63, 0x33, 0x20, 0x73, 0x6E, 0x65, 0x73, 0x50, 0x61, 0x6C, 0x65, 0x74, 0x74, 0x65, 0x43, 0x6F, 0x6C, 0x6F, 
+   0x72, 0x28, 0x75, 0x69, 0x6E, 0x74, 0x20, 0x69, 0x6E, 0x64, 0x65, 0x78, 0x29, 0x7B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x75, 0x69, 0x6E, 0x74, 0x20, 0x63, 0x20, 0x3D, 0x20, 0x74, 0x65, 0x78, 0x65, 0x6C, 0x46, 0x65, 0x74, 0x63, 0x68, 0x28, 0x75, 0x53, 
+   0x6E, 0x65, 0x73, 0x50, 0x61, 0x6C, 0x65, 0x74, 0x74, 0x65, 0x2C, 0x20, 0x69, 0x76, 0x65, 0x63, 0x32, 0x28, 0x69, 0x6E, 0x74, 0x28, 0x69, 0x6E, 0x64, 0x65, 0x78, 0x29, 0x2C, 0x20, 0x30, 0x29, 0x2C, 0x20, 0x30, 0x29, 0x2E, 0x72, 0x3B, 0x0D, 0x0A, 
+   0x20, 0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6E, 0x20, 0x75, 0x76, 0x65, 0x63, 0x33, 0x28, 0x63, 0x20, 0x26, 0x20, 0x33, 0x31, 0x75, 0x2C, 0x20, 0x28, 0x63, 0x20, 0x3E, 0x3E, 0x20, 0x35, 0x29, 0x20, 0x26, 0x20, 0x33, 0x31, 0x75, 0x2C, 0x20, 
+   0x28, 0x63, 0x20, 0x3E, 0x3E, 0x20, 0x31, 0x30, 0x29, 0x20, 0x26, 0x20, 0x33, 0x31, 0x75, 0x29, 0x3B, 0x0D, 0x0A, 0x7D, 0x0D, 0x0A, 0x0D, 0x0A, 0x76, 0x65, 0x63, 0x34, 0x20, 0x73, 0x6E, 0x65, 0x73, 0x52, 0x65, 0x73, 0x6F, 0x6C, 0x76, 0x65, 0x28, 
+   0x69, 0x76, 0x65, 0x63, 0x32, 0x20, 0x70, 0x69, 0x78, 0x65, 0x6C, 0x29, 0x7B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x74, 0x61, 0x72, 0x67, 0x65, 0x74, 0x20, 0x69, 0x73, 0x20, 0x35, 0x31, 0x32, 0x20, 0x77, 0x69, 0x64, 0x65, 0x20, 0x6C, 0x69, 
+   0x6B, 0x65, 0x20, 0x73, 0x6E, 0x65, 0x73, 0x52, 0x65, 0x6E, 0x64, 0x65, 0x72, 0x2C, 0x20, 0x65, 0x76, 0x65, 0x72, 0x79, 0x20, 0x73, 0x6E, 0x65, 0x73, 0x20, 0x70, 0x69, 0x78, 0x65, 0x6C, 0x20, 0x69, 0x73, 0x20, 0x64, 0x6F, 0x75, 0x62, 0x6C, 0x65, 
+   0x64, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x69, 0x76, 0x65, 0x63, 0x32, 0x20, 0x73, 0x6E, 0x65, 0x73, 0x50, 0x69, 0x78, 0x65, 0x6C, 0x20, 0x3D, 0x20, 0x69, 0x76, 0x65, 0x63, 0x32, 0x28, 0x70, 0x69, 0x78, 0x65, 0x6C, 0x2E, 0x78, 0x20, 0x2F, 0x20, 0x32, 
+   0x2C, 0x20, 0x70, 0x69, 0x78, 0x65, 0x6C, 0x2E, 0x79, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x75, 0x69, 0x6E, 0x74, 0x20, 0x69, 0x6E, 0x64, 0x69, 0x63, 0x65, 0x73, 0x20, 0x3D, 0x20, 0x74, 0x65, 0x78, 0x65, 0x6C, 0x46, 0x65, 0x74, 0x63, 0x68, 
+   0x28, 0x75, 0x53, 0x6E, 0x65, 0x73, 0x49, 0x6E, 0x64, 0x69, 0x63, 0x65, 0x73, 0x2C, 0x20, 0x73, 0x6E, 0x65, 0x73, 0x50, 0x69, 0x78, 0x65, 0x6C, 0x2C, 0x20, 0x30, 0x29, 0x2E, 0x72, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x75, 0x69, 0x6E, 0x74, 0x20, 
+   0x66, 0x6C, 0x61, 0x67, 0x73, 0x20, 0x3D, 0x20, 0x74, 0x65, 0x78, 0x65, 0x6C, 0x46, 0x65, 0x74, 0x63, 0x68, 0x28, 0x75, 0x53, 0x6E, 0x65, 0x73, 0x46, 0x6C, 0x61, 0x67, 0x73, 0x2C, 0x20, 0x73, 0x6E, 0x65, 0x73, 0x50, 0x69, 0x78, 0x65, 0x6C, 0x2C, 
+   0x20, 0x30, 0x29, 0x2E, 0x72, 0x3B, 0x0D, 0x0A, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x53, 0x4E, 0x45, 0x53, 0x5F, 0x49, 0x4E, 0x44, 0x45, 0x58, 0x45, 0x44, 0x5F, 0x48, 0x49, 0x52, 0x45, 0x53, 0x2C, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6C, 0x65, 
+   0x66, 0x74, 0x20, 0x68, 0x61, 0x6C, 0x66, 0x20, 0x6F, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x70, 0x61, 0x69, 0x72, 0x20, 0x73, 0x68, 0x6F, 0x77, 0x73, 0x20, 0x74, 0x68, 0x65, 0x20, 0x73, 0x75, 0x62, 0x20, 0x73, 0x63, 0x72, 0x65, 0x65, 0x6E, 0x0D, 
+   0x0A, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x61, 0x20, 0x74, 0x72, 0x61, 0x6E, 0x73, 0x70, 0x61, 0x72, 0x65, 0x6E, 0x74, 0x20, 0x73, 0x75, 0x62, 0x20, 0x73, 0x63, 0x72, 0x65, 0x65, 0x6E, 0x20, 0x73, 0x68, 0x6F, 0x77, 0x73, 0x20, 0x74, 0x68, 0x65, 0x20, 
+   0x62, 0x61, 0x63, 0x6B, 0x64, 0x72, 0x6F, 0x70, 0x2C, 0x20, 0x53, 0x4E, 0x45, 0x53, 0x5F, 0x49, 0x4E, 0x44, 0x45, 0x58, 0x45, 0x44, 0x5F, 0x42, 0x41, 0x43, 0x4B, 0x44, 0x52, 0x4F, 0x50, 0x5F, 0x57, 0x48, 0x49, 0x54, 0x45, 0x20, 0x69, 0x73, 0x20, 
+   0x73, 0x65, 0x74, 0x20, 0x6F, 0x6E, 0x20, 0x68, 0x69, 0x72, 0x65, 0x73, 0x20, 0x70, 0x69, 0x78, 0x65, 0x6C, 0x73, 0x20, 0x66, 0x6F, 0x72, 0x20, 0x69, 0x74, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x69, 0x66, 0x28, 0x28, 0x66, 0x6C, 0x61, 0x67, 0x73, 0x20, 
+   0x26, 0x20, 0x33, 0x32, 0x75, 0x29, 0x20, 0x21, 0x3D, 0x20, 0x30, 0x75, 0x20, 0x26, 0x26, 0x20, 0x28, 0x70, 0x69, 0x78, 0x65, 0x6C, 0x2E, 0x78, 0x20, 0x26, 0x20, 0x31, 0x29, 0x20, 0x3D, 0x3D, 0x20, 0x30, 0x29, 0x7B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 
+   0x20, 0x20, 0x20, 0x69, 0x66, 0x28, 0x28, 0x69, 0x6E, 0x64, 0x69, 0x63, 0x65, 0x73, 0x20, 0x3E, 0x3E, 0x20, 0x38, 0x29, 0x20, 0x3D, 0x3D, 0x20, 0x30, 0x75, 0x29, 0x7B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 
+   0x74, 0x75, 0x72, 0x6E, 0x20, 0x28, 0x66, 0x6C, 0x61, 0x67, 0x73, 0x20, 0x26, 0x20, 0x31, 0x36, 0x75, 0x29, 0x20, 0x21, 0x3D, 0x20, 0x30, 0x75, 0x20, 0x3F, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x31, 0x2E, 0x30, 0x29, 0x20, 0x3A, 0x20, 0x76, 0x65, 
+   0x63, 0x34, 0x28, 0x30, 0x2E, 0x30, 0x2C, 0x20, 0x30, 0x2E, 0x30, 0x2C, 0x20, 0x30, 0x2E, 0x30, 0x2C, 0x20, 0x31, 0x2E, 0x30, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x7D, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x75, 
+   0x76, 0x65, 0x63, 0x33, 0x20, 0x73, 0x75, 0x62, 0x20, 0x3D, 0x20, 0x73, 0x6E, 0x65, 0x73, 0x50, 0x61, 0x6C, 0x65, 0x74, 0x74, 0x65, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x28, 0x69, 0x6E, 0x64, 0x69, 0x63, 0x65, 0x73, 0x20, 0x3E, 0x3E, 0x20, 0x38, 0x29, 
+   0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x76, 0x65, 0x63, 0x33, 0x28, 0x28, 0x73, 0x75, 0x62, 0x20, 0x3C, 0x3C, 0x20, 0x33, 0x29, 0x20, 0x7C, 0x20, 0x28, 0x73, 
+   0x75, 0x62, 0x20, 0x3E, 0x3E, 0x20, 0x32, 0x29, 0x29, 0x20, 0x2F, 0x20, 0x32, 0x35, 0x35, 0x2E, 0x30, 0x2C, 0x20, 0x31, 0x2E, 0x30, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x7D, 0x0D, 0x0A, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x53, 0x4E, 
+   0x45, 0x53, 0x5F, 0x49, 0x4E, 0x44, 0x45, 0x58, 0x45, 0x44, 0x5F, 0x42, 0x41, 0x43, 0x4B, 0x44, 0x52, 0x4F, 0x50, 0x2C, 0x20, 0x53, 0x4E, 0x45, 0x53, 0x5F, 0x49, 0x4E, 0x44, 0x45, 0x58, 0x45, 0x44, 0x5F, 0x42, 0x41, 0x43, 0x4B, 0x44, 0x52, 0x4F, 
+   0x50, 0x5F, 0x57, 0x48, 0x49, 0x54, 0x45, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x69, 0x66, 0x28, 0x28, 0x66, 0x6C, 0x61, 0x67, 0x73, 0x20, 0x26, 0x20, 0x38, 0x75, 0x29, 0x20, 0x21, 0x3D, 0x20, 0x30, 0x75, 0x29, 0x7B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 
+   0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6E, 0x20, 0x28, 0x66, 0x6C, 0x61, 0x67, 0x73, 0x20, 0x26, 0x20, 0x31, 0x36, 0x75, 0x29, 0x20, 0x21, 0x3D, 0x20, 0x30, 0x75, 0x20, 0x3F, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x31, 0x2E, 0x30, 0x29, 0x20, 
+   0x3A, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x30, 0x2E, 0x30, 0x2C, 0x20, 0x30, 0x2E, 0x30, 0x2C, 0x20, 0x30, 0x2E, 0x30, 0x2C, 0x20, 0x31, 0x2E, 0x30, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x7D, 0x0D, 0x0A, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x75, 
+   0x76, 0x65, 0x63, 0x33, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x73, 0x6E, 0x65, 0x73, 0x50, 0x61, 0x6C, 0x65, 0x74, 0x74, 0x65, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x28, 0x69, 0x6E, 0x64, 0x69, 0x63, 0x65, 0x73, 0x20, 0x26, 0x20, 0x32, 
+   0x35, 0x35, 0x75, 0x29, 0x3B, 0x0D, 0x0A, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x53, 0x4E, 0x45, 0x53, 0x5F, 0x49, 0x4E, 0x44, 0x45, 0x58, 0x45, 0x44, 0x5F, 0x43, 0x4F, 0x4C, 0x4F, 0x52, 0x5F, 0x4D, 0x41, 0x54, 0x48, 0x2C, 0x20, 0x53, 0x4E, 
+   0x45, 0x53, 0x5F, 0x49, 0x4E, 0x44, 0x45, 0x58, 0x45, 0x44, 0x5F, 0x53, 0x55, 0x42, 0x54, 0x52, 0x41, 0x43, 0x54, 0x2C, 0x20, 0x53, 0x4E, 0x45, 0x53, 0x5F, 0x49, 0x4E, 0x44, 0x45, 0x58, 0x45, 0x44, 0x5F, 0x48, 0x41, 0x4C, 0x56, 0x45, 0x0D, 0x0A, 
+   0x20, 0x20, 0x20, 0x2F, 0x2F, 0x62, 0x79, 0x74, 0x65, 0x20, 0x6D, 0x61, 0x74, 0x68, 0x20, 0x6C, 0x69, 0x6B, 0x65, 0x20, 0x74, 0x68, 0x65, 0x20, 0x63, 0x70, 0x75, 0x20, 0x70, 0x61, 0x74, 0x68, 0x20, 0x73, 0x6F, 0x20, 0x73, 0x75, 0x62, 0x74, 0x72, 
+   0x61, 0x63, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x75, 0x6E, 0x64, 0x65, 0x72, 0x66, 0x6C, 0x6F, 0x77, 0x20, 0x77, 0x72, 0x61, 0x70, 0x73, 0x20, 0x61, 0x6E, 0x64, 0x20, 0x63, 0x6C, 0x61, 0x6D, 0x70, 0x73, 0x20, 0x74, 0x6F, 0x20, 0x33, 0x31, 0x0D, 0x0A, 
+   0x20, 0x20, 0x20, 0x69, 0x66, 0x28, 0x28, 0x66, 0x6C, 0x61, 0x67, 0x73, 0x20, 0x26, 0x20, 0x31, 0x75, 0x29, 0x20, 0x21, 0x3D, 0x20, 0x30, 0x75, 0x29, 0x7B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x53, 0x4E, 0x45, 0x53, 0x5F, 
+   0x49, 0x4E, 0x44, 0x45, 0x58, 0x45, 0x44, 0x5F, 0x4D, 0x41, 0x54, 0x48, 0x5F, 0x42, 0x41, 0x43, 0x4B, 0x44, 0x52, 0x4F, 0x50, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x75, 0x76, 0x65, 0x63, 0x33, 0x20, 0x73, 0x75, 0x62, 0x20, 0x3D, 0x20, 
+   0x73, 0x6E, 0x65, 0x73, 0x50, 0x61, 0x6C, 0x65, 0x74, 0x74, 0x65, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x28, 0x28, 0x66, 0x6C, 0x61, 0x67, 0x73, 0x20, 0x26, 0x20, 0x36, 0x34, 0x75, 0x29, 0x20, 0x21, 0x3D, 0x20, 0x30, 0x75, 0x20, 0x3F, 0x20, 0x30, 0x75, 
+   0x20, 0x3A, 0x20, 0x69, 0x6E, 0x64, 0x69, 0x63, 0x65, 0x73, 0x20, 0x3E, 0x3E, 0x20, 0x38, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x28, 0x66, 0x6C, 0x61, 0x67, 0x73, 0x20, 0x26, 
+   0x20, 0x32, 0x75, 0x29, 0x20, 0x21, 0x3D, 0x20, 0x30, 0x75, 0x20, 0x3F, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x2D, 0x20, 0x73, 0x75, 0x62, 0x20, 0x3A, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x2B, 0x20, 0x73, 0x75, 0x62, 0x3B, 0x0D, 0x0A, 
+   0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x28, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x26, 0x20, 0x32, 0x35, 0x35, 0x75, 0x29, 0x20, 0x3E, 0x3E, 0x20, 0x28, 0x28, 0x66, 0x6C, 0x61, 0x67, 0x73, 0x20, 0x26, 
+   0x20, 0x34, 0x75, 0x29, 0x20, 0x21, 0x3D, 0x20, 0x30, 0x75, 0x20, 0x3F, 0x20, 0x31, 0x75, 0x20, 0x3A, 0x20, 0x30, 0x75, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x6D, 0x69, 0x6E, 
+   0x28, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x2C, 0x20, 0x75, 0x76, 0x65, 0x63, 0x33, 0x28, 0x33, 0x31, 0x75, 0x29, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x7D, 0x0D, 0x0A, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x72, 0x65, 0x74, 0x75, 0x72, 0x6E, 0x20, 0x76, 
+   0x65, 0x63, 0x34, 0x28, 0x76, 0x65, 0x63, 0x33, 0x28, 0x28, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3C, 0x3C, 0x20, 0x33, 0x29, 0x20, 0x7C, 0x20, 0x28, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3E, 0x3E, 0x20, 0x32, 0x29, 0x29, 0x20, 0x2F, 0x20, 0x32, 
+   0x35, 0x35, 0x2E, 0x30, 0x2C, 0x20, 0x31, 0x2E, 0x30, 0x29, 0x3B, 0x0D, 0x0A, 0x7D, 0x0D, 0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x0D, 0x0A, 0x76, 0x6F, 0x69, 0x64, 0x20, 0x6D, 0x61, 0x69, 0x6E, 0x28, 0x29, 0x7B, 0x0D, 0x0A, 0x20, 
+   0x20, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x76, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0D, 0x0A, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x44, 0x49, 0x46, 0x46, 0x55, 
+   0x53, 0x45, 0x5F, 0x54, 0x45, 0x58, 0x54, 0x55, 0x52, 0x45, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x2A, 0x3D, 0x20, 0x74, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x28, 0x75, 0x54, 0x65, 0x78, 0x74, 0x75, 0x72, 0x65, 0x2C, 
+   0x20, 0x76, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x73, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x53, 0x4E, 0x45, 
+   0x53, 0x5F, 0x50, 0x41, 0x4C, 0x45, 0x54, 0x54, 0x45, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x2A, 0x3D, 0x20, 0x73, 0x6E, 0x65, 0x73, 0x52, 0x65, 0x73, 0x6F, 0x6C, 0x76, 0x65, 0x28, 0x69, 0x76, 0x65, 0x63, 0x32, 0x28, 
+   0x67, 0x6C, 0x5F, 0x46, 0x72, 0x61, 0x67, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x2E, 0x78, 0x79, 0x29, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x0D, 0x0A, 0x20, 0x20, 
+   0x20, 0x6F, 0x75, 0x74, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x63, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0D, 0x0A, 0x7D, 0x0D, 0x0A, 0x0D, 0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x0D, 0x0A, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 
+   0x20, 0x56, 0x45, 0x52, 0x54, 0x45, 0x58, 0x0D, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x6D, 0x61, 0x74, 0x34, 0x20, 0x75, 0x4D, 0x6F, 0x64, 0x65, 0x6C, 0x4D, 0x61, 0x74, 0x72, 0x69, 0x78, 0x3B, 0x0D, 0x0A, 0x75, 0x6E, 0x69, 0x66, 
+   0x6F, 0x72, 0x6D, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x75, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x54, 0x72, 0x61, 0x6E, 0x73, 0x66, 0x6F, 0x72, 0x6D, 0x3B, 0x0D, 0x0A, 0x0D, 0x0A, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x52, 0x4F, 0x54, 0x41, 0x54, 
+   0x49, 0x4F, 0x4E, 0x0D, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 0x6D, 0x20, 0x6D, 0x61, 0x74, 0x34, 0x20, 0x75, 0x4D, 0x6F, 0x64, 0x65, 0x6C, 0x52, 0x6F, 0x74, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x3B, 0x0D, 0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 
+   0x0D, 0x0A, 0x0D, 0x0A, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x61, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x3B, 0x0D, 0x0A, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x43, 0x4F, 0x4C, 0x4F, 0x52, 0x5F, 0x41, 0x54, 0x54, 0x52, 
+   0x49, 0x42, 0x55, 0x54, 0x45, 0x0D, 0x0A, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x61, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0D, 0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x6F, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 
+   0x76, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x3B, 0x0D, 0x0A, 0x0D, 0x0A, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x44, 0x49, 0x46, 0x46, 0x55, 0x53, 0x45, 0x5F, 0x54, 0x45, 0x58, 0x54, 0x55, 0x52, 0x45, 0x0D, 0x0A, 0x75, 0x6E, 0x69, 0x66, 0x6F, 0x72, 
+   0x6D, 0x20, 0x6D, 0x61, 0x74, 0x34, 0x20, 0x75, 0x54, 0x65, 0x78, 0x4D, 0x61, 0x74, 0x72, 0x69, 0x78, 0x3B, 0x0D, 0x0A, 0x69, 0x6E, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x61, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x73, 0x3B, 0x0D, 0x0A, 
+   0x6F, 0x75, 0x74, 0x20, 0x76, 0x65, 0x63, 0x32, 0x20, 0x76, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x73, 0x3B, 0x0D, 0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x0D, 0x0A, 0x76, 0x6F, 0x69, 0x64, 0x20, 0x6D, 0x61, 0x69, 0x6E, 
+   0x28, 0x29, 0x20, 0x7B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x43, 0x4F, 0x4C, 0x4F, 0x52, 0x5F, 0x41, 0x54, 0x54, 0x52, 0x49, 0x42, 0x55, 0x54, 0x45, 0x0D, 0x0A, 0x09, 0x76, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 
+   0x3D, 0x20, 0x61, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x2A, 0x20, 0x75, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x54, 0x72, 0x61, 0x6E, 0x73, 0x66, 0x6F, 0x72, 0x6D, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x65, 0x6C, 0x73, 0x65, 0x0D, 0x0A, 0x09, 0x76, 
+   0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x20, 0x3D, 0x20, 0x75, 0x43, 0x6F, 0x6C, 0x6F, 0x72, 0x54, 0x72, 0x61, 0x6E, 0x73, 0x66, 0x6F, 0x72, 0x6D, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x20, 
+   0x20, 0x20, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x44, 0x49, 0x46, 0x46, 0x55, 0x53, 0x45, 0x5F, 0x54, 0x45, 0x58, 0x54, 0x55, 0x52, 0x45, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x63, 0x6F, 
+   0x6F, 0x72, 0x64, 0x20, 0x3D, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x61, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x73, 0x2C, 0x20, 0x30, 0x2E, 0x30, 0x2C, 0x20, 0x31, 0x2E, 0x30, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x63, 0x6F, 0x6F, 
+   0x72, 0x64, 0x20, 0x3D, 0x20, 0x75, 0x54, 0x65, 0x78, 0x4D, 0x61, 0x74, 0x72, 0x69, 0x78, 0x20, 0x2A, 0x20, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x76, 0x54, 0x65, 0x78, 0x43, 0x6F, 0x6F, 0x72, 0x64, 0x73, 0x20, 0x3D, 
+   0x20, 0x63, 0x6F, 0x6F, 0x72, 0x64, 0x2E, 0x78, 0x79, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x76, 0x65, 0x63, 0x34, 0x20, 0x70, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 
+   0x20, 0x3D, 0x20, 0x76, 0x65, 0x63, 0x34, 0x28, 0x61, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x2C, 0x20, 0x30, 0x2C, 0x20, 0x31, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x6D, 0x61, 0x74, 0x34, 0x20, 0x6D, 0x6F, 0x64, 0x65, 0x6C, 0x20, 
+   0x3D, 0x20, 0x75, 0x4D, 0x6F, 0x64, 0x65, 0x6C, 0x4D, 0x61, 0x74, 0x72, 0x69, 0x78, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x69, 0x66, 0x64, 0x65, 0x66, 0x20, 0x52, 0x4F, 0x54, 0x41, 0x54, 0x49, 0x4F, 0x4E, 0x0D, 0x0A, 0x09, 0x6D, 0x6F, 0x64, 
+   0x65, 0x6C, 0x20, 0x2A, 0x3D, 0x20, 0x75, 0x4D, 0x6F, 0x64, 0x65, 0x6C, 0x52, 0x6F, 0x74, 0x61, 0x74, 0x69, 0x6F, 0x6E, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x0D, 0x0A, 0x09, 0x20, 0x20, 0x0D, 0x0A, 0x20, 0x20, 
+   0x20, 0x67, 0x6C, 0x5F, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x75, 0x56, 0x69, 0x65, 0x77, 0x4D, 0x61, 0x74, 0x72, 0x69, 0x78, 0x20, 0x2A, 0x20, 0x28, 0x6D, 0x6F, 0x64, 0x65, 0x6C, 0x20, 0x2A, 0x20, 0x70, 0x6F, 0x73, 
+   0x69, 0x74, 0x69, 0x6F, 0x6E, 0x29, 0x3B, 0x0D, 0x0A, 0x20, 0x20, 0x20, 0x2F, 0x2F, 0x67, 0x6C, 0x5F, 0x50, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x20, 0x3D, 0x20, 0x70, 0x6F, 0x73, 0x69, 0x74, 0x69, 0x6F, 0x6E, 0x3B, 0x0D, 0x0A, 0x7D, 0x0D, 
+   0x0A, 0x23, 0x65, 0x6E, 0x64, 0x69, 0x66, 0x00);
 
 
@@ -11,6 +11,7 @@
 
 #include "libutils/IncludeWindows.h"
 #include "libutils/CheckedMemory.h"
+#include "libutils/Bitplanes.h"
 
 #include <GL/glew.h>
 #include <SDL2/SDL.h>
@@ -461,7 +462,7 @@ void _viewerUpdate(GUIWindow *self, AppData *data) {
       struct nk_rect bounds;
       state = nk_widget(&bounds, ctx);
       if (state) {
-         uint32_t handle = textureGetGLHandle(data->snesTex);
+         uint32_t handle = data->snesFrameIndexed ? fboGetGLHandle(data->snesFBO) : textureGetGLHandle(data->snesTex);
          struct nk_image img = nk_image_id(handle);
          nk_draw_image(nk_window_get_canvas(ctx), bounds, &img, nk_rgb(255, 255, 255));
 
@@ -624,6 +625,25 @@ void _optionsUpdate(GUIWindow *self, AppData *data) {
 
          nk_layout_row_dynamic(ctx, 20, 1);
          nk_checkbox_label(ctx, "Debug Render", (int*)&data->snesRenderWhite);
+         nk_checkbox_label(ctx, "Indexed Render", &data->snesRenderIndexed);
+         nk_checkbox_label(ctx, "Pipelined Render", &data->snesRenderPipelined);
+
+         // snapshot for snesbench
+         if (nk_button_label(ctx, "Save SNES State")) {
+            if (snesSaveState(data->snes, "snesstate.bin")) {
+               LOG(TAG, LOG_SUCCESS, "Saved SNES state to snesstate.bin");
+            }
+            else {
+               LOG(TAG, LOG_ERR, "Failed to save SNES state");
+            }
+         }
+
+         nk_layout_row_begin(ctx, NK_DYNAMIC, 20, 2);
+         nk_layout_row_push(ctx, 0.35f);
+         nk_labelf(ctx, NK_TEXT_RIGHT, "Render Threads: %i", data->snesRenderThreads);
+         nk_layout_row_push(ctx, 0.65f);
+         data->snesRenderThreads = nk_slide_int(ctx, 1, data->snesRenderThreads, 16, 1);
+         nk_layout_row_end(ctx);
 
          nk_layout_row_begin(ctx, NK_DYNAMIC, 20, 2);
          nk_layout_row_push(ctx, 0.35f);
@@ -1735,6 +1755,7 @@ static void _commitCharacterMapToDB(CharTool *self,  AppData *data, boolean upda
       for (x = 0; x < newcmap.width; ++x) {
          byte tX = 0, tY = 0;
          byte pIdx = self->tilePaletteMap[y*newcmap.width+x];   
+         byte pixels[8 * 8] = { 0 };
 
          //need to figure out what char4 of the target to start at
          Char4 *target = ((Char4*)newcmap.data) + ((y*newcmap.width + x) * tileChar4Size);
@@ -1749,20 +1770,13 @@ static void _commitCharacterMapToDB(CharTool *self,  AppData *data, boolean upda
 
                   if (entryIdx >= 0) {
                      ColorMapEntry *entry = vecAt(ColorMapEntry)(self->importedColors, entryIdx);
-                     byte cIdx = entry->encodingIndex[pIdx];
-                     if (cIdx >= 0) {
-                        byte c4Idx = 0;
-
-                        for (c4Idx = 0; c4Idx < tileChar4Size; ++c4Idx) {
-                           Char4 *dest = target + c4Idx;
-                           dest->rows[tY].planes[0] |= !!(cIdx & (1 << (c4Idx * 2))) << tX;
-                           dest->rows[tY].planes[1] |= !!(cIdx & (1 << (c4Idx * 2 + 1))) << tX;
-                        }
-                     }
+                     pixels[tY * 8 + tX] = (byte)entry->encodingIndex[pIdx];
                   }
                }
             }
          }
+
+         bitplanesEncode(pixels, (int)tileChar4Size * 2, (byte*)target, 1);
       }
    }
 
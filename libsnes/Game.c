@@ -51,10 +51,10 @@ static void _setupTestSNES(SNES *snes, AppData *data) {
 
 
    DBCharacterMaps hades = dbCharacterMapsSelectFirstByid(data->db, 25);
-   CMap *hmap = cMapCreate(&snes->vram, 2, 2, 32);
+   CMap *hmap = cMapCreate(snes, 2, 2, 32);
    CMapBlock *hblock = cMapAlloc(hmap, 4, hades.width, hades.height, 8, 8);
    cMapBlockSetCharacters(hblock, hades.data);
-   cMapCommit(hmap);
+   cMapCommit(hmap, NULL);
    snes->oam.primary[0].character = cMapBlockGetCharacter(hblock, 0, 0);
 
    data->testX = 28;
@@ -76,49 +76,26 @@ static void _setupTestSNES(SNES *snes, AppData *data) {
 
    DBCharacterMaps bg = dbCharacterMapsSelectFirstByid(data->db, 29);
 
-   CMap *map = cMapCreate(&snes->vram, 4, 4, 60);
+   CMap *map = cMapCreate(snes, 4, 4, 60);
    CMapBlock *block = cMapAlloc(map, 4, 30, 19, 8, 8);
    cMapBlockSetCharacters(block, bg.data);
-   cMapCommit(map);
+   cMapCommit(map, NULL);
 
 
    //memcpy(&data->snes->vram.mode1.bgCMap, bg.data, bg.dataSize);
 
-   byte2 x = 0, y = 0;
-   for (y = 0; y < bg.height; ++y) {
-      for (x = 0; x < bg.width; ++x) {
-         int i = y * 32 + x;
-         Tile *t = &snes->vram.mode1.bg1TMaps[0].tiles[i];
-
-
-         t->tile.palette = *((byte*)bg.tilePaletteMap + (y*bg.width +x));
-         t->tile.character = cMapBlockGetCharacter(block, x, y);
-         t->tile.priority = 1;
-
-         //byte2 foo = cMapBlockGetCharacter(block, x, y);
-         //byte2 foo2 = (y * bg.width + x);
-
-         //t->tile.character = (y * bg.width + x);
-      }
-   }
+   CMapTileAttributes bgAttributes = { .palettes = bg.tilePaletteMap, .priority = 1 };
+   cMapBlockFillTileMap(block, snes->vram.mode1.bg1TMaps, false, false, 0, 0, 0, 0, bg.width, bg.height, &bgAttributes);
 
    DBCharacterMaps txt = dbCharacterMapsSelectFirstByid(data->db, 28);
-   CMap *map2 = cMapCreate(&snes->vram, 4, 0, 4);
+   CMap *map2 = cMapCreate(snes, 4, 0, 4);
    cMapAlloc(map2, 2, 1, 1, 8, 8);
    CMapBlock *block2 = cMapAlloc(map2, 2, 16, 4, 8, 8);
    cMapBlockSetCharacters(block2, txt.data);
-   cMapCommit(map2);
-
-   for (y = 0; y < 4; ++y) {
-      for (x = 0; x < txt.width; ++x) {
-         int i = y * 32 + x;
-         Tile *t = &snes->vram.mode1.bg3TMap.tiles[i];
+   cMapCommit(map2, NULL);
 
-         t->tile.palette = 3;
-         t->tile.character = cMapBlockGetCharacter(block2, x, y);
-         t->tile.priority = 1;
-      }
-   }
+   CMapTileAttributes txtAttributes = { .palette = 3, .priority = 1 };
+   cMapBlockFillTileMap(block2, &snes->vram.mode1.bg3TMap, false, false, 0, 0, 0, 0, txt.width, 4, &txtAttributes);
    
 
    pals = dbCharacterEncodePaletteSelectBycharacterMapId(data->db, bg.id);
@@ -159,6 +159,7 @@ static void _shaderBuild(Shader *self) {
    const char *DiffuseTextureArrOption = "#define DIFFUSE_TEXTURE_ARRAY\n";
    const char *ColorAttributeOption = "#define COLOR_ATTRIBUTE\n";
    const char *RotationOption = "#define ROTATION\n";
+   const char *SnesPaletteOption = "#define SNES_PALETTE\n";
 
    vec(StringPtr) *vertShader = vecCreate(StringPtr)(&stringPtrDestroy);
    vec(StringPtr) *fragShader = vecCreate(StringPtr)(&stringPtrDestroy);
@@ -189,6 +190,9 @@ static void _shaderBuild(Shader *self) {
    if (self->params&ShaderParams_Color) {
       vecPushBack(StringPtr)(fragShader, &(String*){ stringCreate(ColorAttributeOption) });
    }
+   if (self->params&ShaderParams_SnesPalette) {
+      vecPushBack(StringPtr)(fragShader, &(String*){ stringCreate(SnesPaletteOption) });
+   }
    vecPushBack(StringPtr)(fragShader, &(String*){ stringCreate(file) });
    unsigned int frag = _shaderCompile(self, fragShader, GL_FRAGMENT_SHADER);
 
@@ -243,14 +247,29 @@ void shaderSetTextureSlot(Shader *self, Uniform u, const TextureSlot slot) {
    glUniform1i(u, slot);
 }
 
+typedef struct {
+   GLint internalFormat;
+   GLenum format, type;
+   int pixelSize;
+   boolean integer;
+}TextureFormatInfo;
+
+static const TextureFormatInfo TextureFormats[] = {
+   [TextureFormat_RGBA8] = { GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, sizeof(ColorRGBA), false },
+   [TextureFormat_R8UI] = { GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE, sizeof(byte), true },
+   [TextureFormat_R16UI] = { GL_R16UI, GL_RED_INTEGER, GL_UNSIGNED_SHORT, sizeof(byte2), true },
+};
+
 struct Texture_t {   
    TextureRequest request;
    boolean isLoaded;
    GLuint glHandle;
    ColorRGBA *pixels;
    Int2 size;
+   TextureFormat format;
 
-   boolean dirty;
+   //rows waiting to be uploaded, [dirtyTop, dirtyBottom), nothing when they're equal
+   int dirtyTop, dirtyBottom;
 
    TextureManager *parent;
 };
@@ -338,7 +357,9 @@ static void _textureAcquire(Texture *self) {
    glBindTexture(GL_TEXTURE_2D, self->glHandle);
    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-   switch (self->request.filterType) {
+   const TextureFormatInfo *format = &TextureFormats[self->format];
+
+   switch (format->integer ? FilterType_Nearest : self->request.filterType) {
    case FilterType_Linear:
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
       glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -361,7 +382,7 @@ static void _textureAcquire(Texture *self) {
    };
 
    //glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, self->size.x, self->size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, self->pixels);
+   glTexImage2D(GL_TEXTURE_2D, 0, format->internalFormat, self->size.x, self->size.y, 0, format->format, format->type, self->pixels);
 
    glBindTexture(GL_TEXTURE_2D, 0);
 
@@ -427,6 +448,14 @@ Texture *textureManagerGetTexture(TextureManager *self, const TextureRequest req
    return *found;
 }
 
+static void _textureUpload(Texture *self) {
+   const TextureFormatInfo *format = &TextureFormats[self->format];
+   const byte *rows = (const byte*)self->pixels + self->dirtyTop * self->size.x * format->pixelSize;
+
+   glTexSubImage2D(GL_TEXTURE_2D, 0, 0, self->dirtyTop, self->size.x, self->dirtyBottom - self->dirtyTop, format->format, format->type, rows);
+   self->dirtyTop = self->dirtyBottom = 0;
+}
+
 void textureBind(Texture *self, TextureSlot slot) {
    if (!self->isLoaded) {
       _textureAcquire(self);
@@ -435,9 +464,8 @@ void textureBind(Texture *self, TextureSlot slot) {
    glActiveTexture(GL_TEXTURE0 + slot);
    glBindTexture(GL_TEXTURE_2D, self->glHandle);
 
-   if (self->dirty) {
-      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, self->size.x, self->size.y, GL_RGBA, GL_UNSIGNED_BYTE, self->pixels);
-      self->dirty = false;
+   if (self->dirtyTop != self->dirtyBottom) {
+      _textureUpload(self);
    }
 }
 uint32_t textureGetGLHandle(Texture *self) {
@@ -445,11 +473,10 @@ uint32_t textureGetGLHandle(Texture *self) {
       _textureAcquire(self);
    }
 
-   if (self->dirty) {
+   if (self->dirtyTop != self->dirtyBottom) {
       glBindTexture(GL_TEXTURE_2D, self->glHandle);
-      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, self->size.x, self->size.y, GL_RGBA, GL_UNSIGNED_BYTE, self->pixels);
+      _textureUpload(self);
       glBindTexture(GL_TEXTURE_2D, 0);
-      self->dirty = false;
    }
 
    return self->glHandle;
@@ -475,19 +502,45 @@ void textureDestroy(Texture *self) {
 }
 
 Texture *textureCreateCustom(int width, int height, RepeatType repeatType, FilterType filterType) {
+   return textureCreateCustomFormat(width, height, TextureFormat_RGBA8, repeatType, filterType);
+}
+
+Texture *textureCreateCustomFormat(int width, int height, TextureFormat format, RepeatType repeatType, FilterType filterType) {
    Texture *out = textureCreate((TextureRequest){repeatType, filterType, NULL});
 
    out->size.x = width;
    out->size.y = height;
+   out->format = format;
 
-   out->pixels = checkedCalloc(width * height, sizeof(ColorRGBA));
+   out->pixels = checkedCalloc(width * height, TextureFormats[format].pixelSize);
 
    return out;
 }
 
 void textureSetPixels(Texture *self, byte *data) {
-   memcpy(self->pixels, data, self->size.x * self->size.y * sizeof(ColorRGBA));
-   self->dirty = true;
+   textureSetPixelRows(self, data, 0, self->size.y);
+}
+
+void textureSetPixelRows(Texture *self, byte *data, int firstRow, int rowCount) {
+   size_t rowSize = self->size.x * TextureFormats[self->format].pixelSize;
+   int lastRow = MIN(firstRow + rowCount, self->size.y);
+
+   firstRow = MAX(firstRow, 0);
+   if (firstRow >= lastRow) {
+      return;
+   }
+
+   memcpy((byte*)self->pixels + firstRow * rowSize, data + firstRow * rowSize, (lastRow - firstRow) * rowSize);
+
+   //only one span is tracked, rows between two separate updates get uploaded again too
+   if (self->dirtyTop == self->dirtyBottom) {
+      self->dirtyTop = firstRow;
+      self->dirtyBottom = lastRow;
+   }
+   else {
+      self->dirtyTop = MIN(self->dirtyTop, firstRow);
+      self->dirtyBottom = MAX(self->dirtyBottom, lastRow);
+   }
 }
 
 struct FBO_t {
@@ -567,6 +620,13 @@ void fboBindToRender(FBO *self, TextureSlot slot) {
 Int2 fboGetSize(FBO *self) {
    return self->size;
 }
+uint32_t fboGetGLHandle(FBO *self) {
+   if (!self->loaded) {
+      _fboAcquire(self);
+   }
+
+   return self->texHandle;
+}
 
 
 
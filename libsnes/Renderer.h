@@ -17,6 +17,7 @@ enum {
    ShaderParams_DiffuseTexture = 1 << 0,
    ShaderParams_Color = 1 << 1,
    ShaderParams_Rotation = 1 << 2,
+   ShaderParams_SnesPalette = 1 << 3,
 };
 typedef byte ShaderParams;
 
@@ -44,6 +45,13 @@ enum {
 };
 typedef byte FilterType;
 
+enum {
+   TextureFormat_RGBA8,
+   TextureFormat_R8UI,
+   TextureFormat_R16UI
+};
+typedef byte TextureFormat;
+
 typedef struct {
    RepeatType repeatType;
    FilterType filterType;
@@ -64,10 +72,17 @@ Texture *textureManagerGetTexture(TextureManager *self, const TextureRequest req
 
 Texture *textureCreate(const TextureRequest request);
 Texture *textureCreateCustom(int width, int height, RepeatType repeatType, FilterType filterType);
+
+//integer formats are read with texelFetch from a usampler2D and always filter nearest
+Texture *textureCreateCustomFormat(int width, int height, TextureFormat format, RepeatType repeatType, FilterType filterType);
 void textureDestroy(Texture *self);
 
+//data is width*height pixels of the texture's format
 void textureSetPixels(Texture *self, byte *data);
 
+//same layout as textureSetPixels but only rowCount rows from firstRow are copied and re-uploaded
+void textureSetPixelRows(Texture *self, byte *data, int firstRow, int rowCount);
+
 void textureBind(Texture *self, TextureSlot slot);
 Int2 textureGetSize(Texture *t);
 
@@ -85,6 +100,7 @@ void fboDestroy(FBO *self);
 void fboBindToWrite(FBO *self);
 void fboBindToRender(FBO *self, TextureSlot slot);
 Int2 fboGetSize(FBO *self);
+uint32_t fboGetGLHandle(FBO *self);
 
 typedef struct UBO_t UBO;
 typedef uintptr_t UBOSlot;
@@ -1,6 +1,31 @@
 #include "snes.h"
 #include "libutils/CheckedMemory.h"
 #include "libutils/Rect.h"
+#include "libutils/ThreadPool.h"
+#include "libutils/Bitplanes.h"
+
+#include <string.h>
+#include <stdio.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SNES_X86
+#include <emmintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SNES_TARGET_SSE2
+#else
+// gcc only emits vector instructions the function is targeted for
+#define SNES_TARGET_SSE2 __attribute__((target("sse2")))
+#endif
+#endif
+
+// for helpers written once and specialized by callers that pass them constants
+#ifdef _MSC_VER
+#define SNES_FORCE_INLINE __forceinline
+#else
+#define SNES_FORCE_INLINE inline __attribute__((always_inline))
+#endif
 
 #define OBJS_PER_LINE 32
 #define OBJ_TILES_PER_LINE 34
@@ -20,7 +45,7 @@ typedef struct {
    byte2 vertOffset : 10;
    byte win1Invert : 1, win1Enable : 1, win2Invert : 1, win2Enable : 1, maskLogic : 2, mainMask : 1, subMask : 1;
    byte enableColorMath : 1, colorDepth: 4, bgIdx : 2;
-   byte obj : 1, priority : 2;
+   byte obj : 1, priority : 2, mode7 : 1, hires : 1;
 }ProcessBG;
 
 /* Mode     BG depth  OPT  Priorities
@@ -36,7 +61,7 @@ typedef struct {
 6       4          y    3A 2  1a 0
 7       8          n    3  2  1a 0
 7+EXTBG 8 7        n    3  2B 1a 0b*/
-static void _setupBGs(Registers *r, ProcessBG *bgs, byte *bgCount) {
+static void _setupBGs(const Registers *r, ProcessBG *bgs, byte *bgCount) {
    int i = 0;
 
    //so we collate this mess of registers into a per-BG collection
@@ -63,7 +88,8 @@ static void _setupBGs(Registers *r, ProcessBG *bgs, byte *bgCount) {
       .enableColorMath = r->colorMathControl.bg1
    };
    
-   if (r->bgMode.mode <= 5) {
+   //mode 7 only uses BG2 for EXTBG, where it takes the BG2 screen and window settings but none of the rest
+   if (r->bgMode.mode <= 5 || r->bgMode.mode == 7) {
       BGs[1] = (ProcessBG) {
          .bgIdx = 1,
             .sizeY = r->bgSizeAndTileBase[1].sizeY,
@@ -135,6 +161,11 @@ static void _setupBGs(Registers *r, ProcessBG *bgs, byte *bgCount) {
       };
    }
 
+   //modes 5 and 6 draw their BGs at 512 wide
+   if (r->bgMode.mode == 5 || r->bgMode.mode == 6) {
+      BGs[0].hires = BGs[1].hires = 1;
+   }
+
    //then we build our render list in order of priority
    switch (r->bgMode.mode) {
    case 0:
@@ -152,9 +183,10 @@ static void _setupBGs(Registers *r, ProcessBG *bgs, byte *bgCount) {
       bgs[i] = BGs[3]; bgs[i].colorDepth = 2; bgs[i].priority = 0; ++i; // d      
       break;
    case 1:
-      if (r->bgMode.m1bg3pri) 
-      bgs[i] = BGs[2]; bgs[i].colorDepth = 2; bgs[i].priority = 1; ++i; // C
-      
+      if (r->bgMode.m1bg3pri) {
+         bgs[i] = BGs[2]; bgs[i].colorDepth = 2; bgs[i].priority = 1; ++i; // C
+      }
+
       bgs[i] = (ProcessBG) { .obj = 1, .priority = 3 }; ++i;            // 3
       bgs[i] = BGs[0]; bgs[i].colorDepth = 4; bgs[i].priority = 1; ++i; // A
       //bgs[i] = BGs[1]; bgs[i].colorDepth = 4; bgs[i].priority = 1; ++i; // B
@@ -216,478 +248,1675 @@ static void _setupBGs(Registers *r, ProcessBG *bgs, byte *bgCount) {
       bgs[i] = BGs[0]; bgs[i].colorDepth = 4; bgs[i].priority = 0; ++i; // a
       bgs[i] = (ProcessBG) { .obj = 1, .priority = 0 }; ++i;            // 0
       break;
+   case 7:
+      bgs[i] = (ProcessBG) { .obj = 1, .priority = 3 }; ++i;            // 3
+      bgs[i] = (ProcessBG) { .obj = 1, .priority = 2 }; ++i;            // 2
+      if (r->screenSettings.mode7EXTBG) {
+      bgs[i] = BGs[1]; bgs[i].colorDepth = 7; bgs[i].mode7 = 1; bgs[i].priority = 1; ++i; // B
+      }
+      bgs[i] = (ProcessBG) { .obj = 1, .priority = 1 }; ++i;            // 1
+      bgs[i] = BGs[0]; bgs[i].colorDepth = 8; bgs[i].mode7 = 1; bgs[i].priority = 0; ++i; // a
+      bgs[i] = (ProcessBG) { .obj = 1, .priority = 0 }; ++i;            // 0
+      if (r->screenSettings.mode7EXTBG) {
+      bgs[i] = BGs[1]; bgs[i].colorDepth = 7; bgs[i].mode7 = 1; bgs[i].priority = 0; ++i; // b
+      }
+      break;
+   }
+
+   *bgCount = i;
+}
+
+// hires and pseudo-hires interleave the two screens, the sub screen is the even (left) half of every output pixel
+// and the main screen the odd half, so the sub screen has to be drawn even without color math
+static boolean _lineInterleaved(const Registers *r) {
+   return r->screenSettings.pseudoHiResMode || r->bgMode.mode == 5 || r->bgMode.mode == 6;
+}
+
+static void _tileCacheUpdate(SNESTileCache *self, VRAM *vram) {
+   const Char4 *chars = (const Char4*)vram->raw;
+   size_t word = 0;
+
+   for (word = 0; word < LEN(self->valid); ++word) {
+      size_t c = 0;
+
+      if (self->valid[word] == 0xFFFFFFFF) {
+         continue;
+      }
+
+      // nothing in this stretch is decoded (first render or a whole new vram), do it in bulk
+      if (!self->valid[word]) {
+         size_t c4 = word * 32;
+         bitplanesDecode((const byte*)(chars + c4), 2, self->color4s[c4], 32);
+         bitplanesDecode((const byte*)(chars + c4), 4, self->color16s[c4 >> 1], 16);
+         bitplanesDecode((const byte*)(chars + c4), 8, self->color256s[c4 >> 2], 8);
+         self->valid[word] = 0xFFFFFFFF;
+         continue;
+      }
+
+      // walk a Char256 (4 Char4s) at a time so each larger character is only decoded once
+      for (c = 0; c < 32; c += 4) {
+         size_t c4 = word * 32 + c;
+         byte bits = (self->valid[word] >> c) & 0xF;
+         byte i = 0;
+
+         if (bits == 0xF) {
+            continue;
+         }
+
+         for (i = 0; i < 4; ++i) {
+            if (!(bits & (1 << i))) {
+               bitplanesDecode((const byte*)(chars + c4 + i), 2, self->color4s[c4 + i], 1);
+            }
+         }
+
+         if ((bits & 0x3) != 0x3) {
+            bitplanesDecode((const byte*)(chars + c4), 4, self->color16s[c4 >> 1], 1);
+         }
+         if ((bits & 0xC) != 0xC) {
+            bitplanesDecode((const byte*)(chars + c4 + 2), 4, self->color16s[(c4 >> 1) + 1], 1);
+         }
+
+         bitplanesDecode((const byte*)(chars + c4), 8, self->color256s[c4 >> 2], 1);
+      }
+
+      self->valid[word] = 0xFFFFFFFF;
+   }
+}
+
+static void _paletteCacheUpdate(SNESPaletteCache *cache, const CGRAM *colors) {
+   const byte2 *cgram = (const byte2*)colors;
+   byte2 *shadow = (byte2*)cache->shadow;
+   boolean anyChanged = false;
+   int i = 0;
+
+   memset(cache->changed, 0, sizeof(cache->changed));
+
+   for (i = 0; i < 256; ++i) {
+      if (cache->valid && shadow[i] == cgram[i]) {
+         continue;
+      }
+
+      SNESColor c = colors->colors[i];
+      cache->colors[i] = snesColorConverTo24Bit(c);
+      cache->channels[i][0] = c.r;
+      cache->channels[i][1] = c.g;
+      cache->channels[i][2] = c.b;
+      shadow[i] = cgram[i];
+
+      cache->changed[i >> 5] |= 1u << (i & 31);
+      anyChanged = true;
+   }
+
+   cache->valid = true;
+   if (anyChanged) {
+      ++cache->generation;
+   }
+}
+
+// color math on one 5-bit channel, already expanded to 8 bits
+// indexed [subtract << 1 | halve][main][sub], none of it depends on cgram so its shared by every SNES
+// byte math like the original per-pixel code, so subtraction underflow wraps and clamps to 31
+static byte g_colorMath[4][32][32];
+static boolean g_colorMathBuilt = false;
+
+static void _colorMathBuild() {
+   int op = 0, m = 0, s = 0;
+
+   for (op = 0; op < 4; ++op) {
+      for (m = 0; m < 32; ++m) {
+         for (s = 0; s < 32; ++s) {
+            byte c = (byte)((op & 2) ? m - s : m + s);
+            if (op & 1) {
+               c >>= 1;
+            }
+            c = MIN(31, c);
+            g_colorMath[op][m][s] = (c << 3) | (c >> 2);
+         }
+      }
+   }
+
+   g_colorMathBuilt = true;
+}
+
+// BG pixels normally hold a cgram index, a 256 color BG in direct color mode sets LINE_DIRECT instead
+// and keeps its BBGGGRRR pixel in the low byte with the tile's palette bits (the low bit of b, g, r) above it
+#define LINE_DIRECT 0x8000
+#define LINE_DIRECT_COLOR(px) ((px) & 0x7FF)
+
+// every color a direct color pixel can be, indexed by LINE_DIRECT_COLOR
+// like g_colorMath it never depends on cgram so every SNES shares it
+static struct {
+   ColorRGBA colors[2048];
+   byte channels[2048][4];
+}g_directColors;
+static boolean g_directColorsBuilt = false;
+
+static void _directColorsBuild() {
+   int i = 0;
+
+   for (i = 0; i < LEN(g_directColors.colors); ++i) {
+      byte pixel = (byte)i, bits = (byte)(i >> 8);
+      SNESColor c = { 0 };
+
+      c.r = ((pixel & 7) << 2) | ((bits & 1) << 1);
+      c.g = (((pixel >> 3) & 7) << 2) | (((bits >> 1) & 1) << 1);
+      c.b = ((pixel >> 6) << 3) | (((bits >> 2) & 1) << 2);
+
+      g_directColors.colors[i] = snesColorConverTo24Bit(c);
+      g_directColors.channels[i][0] = c.r;
+      g_directColors.channels[i][1] = c.g;
+      g_directColors.channels[i][2] = c.b;
+   }
+
+   g_directColorsBuilt = true;
+}
+
+// a line value's color, cgram through the palette cache or one of the direct colors
+static ColorRGBA _lineColor(const SNESPaletteCache *palette, byte2 value) {
+   return (value & LINE_DIRECT) ? g_directColors.colors[LINE_DIRECT_COLOR(value)] : palette->colors[value];
+}
+
+// and its 5-bit r, g, b for color math
+static const byte *_lineChannels(const SNESPaletteCache *palette, byte2 value) {
+   return (value & LINE_DIRECT) ? g_directColors.channels[LINE_DIRECT_COLOR(value)] : palette->channels[value];
+}
+
+// a scanline with every color looked up, all that's left is color math and storing the pairs
+// kept as whole arrays so the last stage runs over the line without any lookups or branches
+typedef struct {
+   uint32_t mainChannels[SNES_SIZE_X]; //5-bit r, g, b bytes of the main pixel
+   uint32_t subChannels[SNES_SIZE_X]; //and of whatever color math takes from the sub screen
+   ColorRGBA plain[SNES_SIZE_X]; //the finished pixel wherever color math doesnt apply
+   ColorRGBA left[SNES_SIZE_X]; //the left half of each pair, only read for interleaved lines
+   byte math[SNES_SIZE_X]; //0xFF where color math applies, otherwise 0
+}ResolvedLine;
+
+// does color math where line->math is set and stores every pixel as its pair, op indexes g_colorMath
+// interleaved lines take the left half of each pair from line->left instead of doubling the pixel
+typedef void(*ResolveFunc)(const ResolvedLine *line, byte op, boolean interleaved, ColorRGBA *out);
+
+// fills every pixel of pIdx that earlier entries left transparent from line, so the first opaque entry wins
+// tags records which entry each pixel came from
+typedef void(*RouteFunc)(const byte2 *line, byte2 tag, byte2 *pIdx, byte2 *tags);
+
+// the same for a line drawn unchanged to both screens, each pixel is read once for the two of them
+typedef void(*RouteBothFunc)(const byte2 *line, byte2 tag, byte2 *mainPIdx, byte2 *mainTags, byte2 *subPIdx, byte2 *subTags);
+
+// picked the first time a frame renders
+static ResolveFunc g_resolveLine = NULL;
+static RouteFunc g_routeLine = NULL;
+static RouteBothFunc g_routeLineBoth = NULL;
+
+static void _resolveLineScalar(const ResolvedLine *line, byte op, boolean interleaved, ColorRGBA *out) {
+   const byte (*math)[32] = g_colorMath[op];
+   int x = 0;
+
+   for (x = 0; x < SNES_SIZE_X; ++x, out += 2) {
+      ColorRGBA color24 = line->plain[x];
+
+      if (line->math[x]) {
+         const byte *mainc = (const byte*)&line->mainChannels[x];
+         const byte *subc = (const byte*)&line->subChannels[x];
+
+         color24.r = math[mainc[0]][subc[0]];
+         color24.g = math[mainc[1]][subc[1]];
+         color24.b = math[mainc[2]][subc[2]];
+         color24.a = 255;
+      }
+
+      *out = interleaved ? line->left[x] : color24;
+      *(out + 1) = color24;
+   }
+}
+
+// masks instead of branches, an open pixel is 0 so or'ing the taken pixel in is enough
+static void _routeLineScalar(const byte2 *line, byte2 tag, byte2 *pIdx, byte2 *tags) {
+   int x = 0;
+
+   for (x = 0; x < SNES_SIZE_X; ++x) {
+      byte2 px = line[x];
+      byte2 take = (byte2)(0 - ((pIdx[x] == 0) & (px != 0)));
+
+      pIdx[x] |= px & take;
+      tags[x] = (tags[x] & ~take) | (tag & take);
+   }
+}
+
+static void _routeLineBothScalar(const byte2 *line, byte2 tag, byte2 *mainPIdx, byte2 *mainTags, byte2 *subPIdx, byte2 *subTags) {
+   int x = 0;
+
+   for (x = 0; x < SNES_SIZE_X; ++x) {
+      byte2 px = line[x];
+      byte2 mainTake = (byte2)(0 - ((mainPIdx[x] == 0) & (px != 0)));
+      byte2 subTake = (byte2)(0 - ((subPIdx[x] == 0) & (px != 0)));
+
+      mainPIdx[x] |= px & mainTake;
+      mainTags[x] = (mainTags[x] & ~mainTake) | (tag & mainTake);
+      subPIdx[x] |= px & subTake;
+      subTags[x] = (subTags[x] & ~subTake) | (tag & subTake);
+   }
+}
+
+#ifdef SNES_X86
+// the same byte math as g_colorMath on 4 pixels a register, so subtraction wraps within each channel
+// then the math and plain pixels are blended by mask and interleaved straight into their pairs
+SNES_TARGET_SSE2
+static void _resolveLineSSE2(const ResolvedLine *line, byte op, boolean interleaved, ColorRGBA *out) {
+   const __m128i max = _mm_set1_epi8(31);
+   const __m128i halveMask = _mm_set1_epi8(0x7F);
+   const __m128i highMask = _mm_set1_epi8((char)0xF8);
+   const __m128i lowMask = _mm_set1_epi8(0x07);
+   const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+   int x = 0;
+
+   for (x = 0; x < SNES_SIZE_X; x += 4, out += 8) {
+      __m128i mainc = _mm_loadu_si128((const __m128i*)(line->mainChannels + x));
+      __m128i subc = _mm_loadu_si128((const __m128i*)(line->subChannels + x));
+      __m128i c = (op & 2) ? _mm_sub_epi8(mainc, subc) : _mm_add_epi8(mainc, subc);
+      uint32_t mathFlags = 0;
+
+      //16-bit shifts pull in the neighbouring byte's low bit, masked back out
+      if (op & 1) {
+         c = _mm_and_si128(_mm_srli_epi16(c, 1), halveMask);
+      }
+      c = _mm_min_epu8(c, max);
+
+      //5 to 8 bits like snesColorConverTo24Bit
+      c = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(c, 3), highMask), _mm_and_si128(_mm_srli_epi16(c, 2), lowMask));
+      c = _mm_or_si128(c, alpha);
+
+      //spread each pixel's math byte across its 4 bytes to pick between the two
+      memcpy(&mathFlags, line->math + x, sizeof(mathFlags));
+      __m128i mask = _mm_cvtsi32_si128((int)mathFlags);
+      mask = _mm_unpacklo_epi8(mask, mask);
+      mask = _mm_unpacklo_epi16(mask, mask);
+
+      __m128i plain = _mm_loadu_si128((const __m128i*)(line->plain + x));
+      __m128i color = _mm_or_si128(_mm_and_si128(mask, c), _mm_andnot_si128(mask, plain));
+      __m128i left = interleaved ? _mm_loadu_si128((const __m128i*)(line->left + x)) : color;
+
+      _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi32(left, color));
+      _mm_storeu_si128((__m128i*)(out + 4), _mm_unpackhi_epi32(left, color));
+   }
+}
+
+// 8 pixels a register, a pixel is taken where the screen is still 0 and the line isn't
+SNES_TARGET_SSE2
+static void _routeLineSSE2(const byte2 *line, byte2 tag, byte2 *pIdx, byte2 *tags) {
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i tagv = _mm_set1_epi16((short)tag);
+   int x = 0;
+
+   for (x = 0; x < SNES_SIZE_X; x += 8) {
+      __m128i px = _mm_loadu_si128((const __m128i*)(line + x));
+      __m128i cur = _mm_loadu_si128((const __m128i*)(pIdx + x));
+      __m128i take = _mm_andnot_si128(_mm_cmpeq_epi16(px, zero), _mm_cmpeq_epi16(cur, zero));
+      __m128i curTags = _mm_loadu_si128((const __m128i*)(tags + x));
+
+      _mm_storeu_si128((__m128i*)(pIdx + x), _mm_or_si128(cur, _mm_and_si128(px, take)));
+      _mm_storeu_si128((__m128i*)(tags + x), _mm_or_si128(_mm_andnot_si128(take, curTags), _mm_and_si128(tagv, take)));
+   }
+}
+
+SNES_TARGET_SSE2
+static void _routeLineBothSSE2(const byte2 *line, byte2 tag, byte2 *mainPIdx, byte2 *mainTags, byte2 *subPIdx, byte2 *subTags) {
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i tagv = _mm_set1_epi16((short)tag);
+   int x = 0;
+
+   for (x = 0; x < SNES_SIZE_X; x += 8) {
+      __m128i px = _mm_loadu_si128((const __m128i*)(line + x));
+      __m128i clear = _mm_cmpeq_epi16(px, zero);
+      __m128i mainCur = _mm_loadu_si128((const __m128i*)(mainPIdx + x));
+      __m128i subCur = _mm_loadu_si128((const __m128i*)(subPIdx + x));
+      __m128i mainTake = _mm_andnot_si128(clear, _mm_cmpeq_epi16(mainCur, zero));
+      __m128i subTake = _mm_andnot_si128(clear, _mm_cmpeq_epi16(subCur, zero));
+      __m128i mainCurTags = _mm_loadu_si128((const __m128i*)(mainTags + x));
+      __m128i subCurTags = _mm_loadu_si128((const __m128i*)(subTags + x));
+
+      _mm_storeu_si128((__m128i*)(mainPIdx + x), _mm_or_si128(mainCur, _mm_and_si128(px, mainTake)));
+      _mm_storeu_si128((__m128i*)(mainTags + x), _mm_or_si128(_mm_andnot_si128(mainTake, mainCurTags), _mm_and_si128(tagv, mainTake)));
+      _mm_storeu_si128((__m128i*)(subPIdx + x), _mm_or_si128(subCur, _mm_and_si128(px, subTake)));
+      _mm_storeu_si128((__m128i*)(subTags + x), _mm_or_si128(_mm_andnot_si128(subTake, subCurTags), _mm_and_si128(tagv, subTake)));
+   }
+}
+
+#ifdef _MSC_VER
+static boolean _cpuHasSSE2() {
+   int info[4];
+   __cpuid(info, 1);
+   return (info[3] & (1 << 26)) != 0;
+}
+#else
+static boolean _cpuHasSSE2() { return __builtin_cpu_supports("sse2") != 0; }
+#endif
+
+#endif
+
+static boolean g_simdAllowed = true;
+
+static void _lineKernelsSelect() {
+   ResolveFunc resolve = &_resolveLineScalar;
+   RouteFunc route = &_routeLineScalar;
+   RouteBothFunc routeBoth = &_routeLineBothScalar;
+
+#ifdef SNES_X86
+   if (g_simdAllowed && _cpuHasSSE2()) {
+      resolve = &_resolveLineSSE2;
+      route = &_routeLineSSE2;
+      routeBoth = &_routeLineBothSSE2;
+   }
+#endif
+
+   g_resolveLine = resolve;
+   g_routeLine = route;
+   g_routeLineBoth = routeBoth;
+}
+
+void snesRenderSetSIMD(boolean allowed) {
+   g_simdAllowed = allowed;
+   _lineKernelsSelect();
+}
+
+boolean snesRenderGetSIMD() {
+   if (!g_resolveLine) {
+      _lineKernelsSelect();
+   }
+   return g_resolveLine != &_resolveLineScalar;
+}
+
+#define SNES_STATE_MAGIC "SNESSTAT"
+#define SNES_STATE_VERSION 2
+
+typedef struct {
+   char magic[8];
+   uint32_t version;
+   uint32_t cgramSize, vramSize, oamSize, regSize, latchSize;
+}SNESStateHeader;
+
+static void _stateHeaderInit(SNESStateHeader *header) {
+   memset(header, 0, sizeof(SNESStateHeader));
+   memcpy(header->magic, SNES_STATE_MAGIC, sizeof(header->magic));
+   header->version = SNES_STATE_VERSION;
+   header->cgramSize = sizeof(CGRAM);
+   header->vramSize = sizeof(VRAM);
+   header->oamSize = sizeof(OAM);
+   header->regSize = sizeof(Registers);
+   header->latchSize = sizeof(SNESRegisterLatches);
+}
+
+boolean snesSaveState(SNES *self, const char *path) {
+   SNESStateHeader header;
+   boolean ok = false;
+   FILE *f = fopen(path, "wb");
+
+   if (!f) {
+      return false;
+   }
+
+   _stateHeaderInit(&header);
+   ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+      fwrite(&self->cgram, sizeof(CGRAM), 1, f) == 1 &&
+      fwrite(&self->vram, sizeof(VRAM), 1, f) == 1 &&
+      fwrite(&self->oam, sizeof(OAM), 1, f) == 1 &&
+      fwrite(&self->reg, sizeof(Registers), 1, f) == 1 &&
+      fwrite(&self->latches, sizeof(SNESRegisterLatches), 1, f) == 1;
+
+   return fclose(f) == 0 && ok;
+}
+
+boolean snesLoadState(SNES *self, const char *path) {
+   SNESStateHeader header, expected;
+   SNES *loaded = NULL;
+   boolean ok = false;
+   FILE *f = fopen(path, "rb");
+
+   if (!f) {
+      return false;
+   }
+
+   _stateHeaderInit(&expected);
+   if (fread(&header, sizeof(header), 1, f) != 1 || memcmp(&header, &expected, sizeof(header))) {
+      fclose(f);
+      return false;
+   }
+
+   // read into a scratch copy so a truncated file leaves self alone
+   loaded = checkedCalloc(1, sizeof(SNES));
+   ok = fread(&loaded->cgram, sizeof(CGRAM), 1, f) == 1 &&
+      fread(&loaded->vram, sizeof(VRAM), 1, f) == 1 &&
+      fread(&loaded->oam, sizeof(OAM), 1, f) == 1 &&
+      fread(&loaded->reg, sizeof(Registers), 1, f) == 1 &&
+      fread(&loaded->latches, sizeof(SNESRegisterLatches), 1, f) == 1;
+   fclose(f);
+
+   if (ok) {
+      *self = *loaded;
+   }
+
+   checkedFree(loaded);
+   return ok;
+}
+
+// reg with every latch at or above line applied, what that line renders with
+static void _latchedRegisters(SNES *self, int line, Registers *out) {
+   const SNESRegisterLatches *latches = &self->latches;
+   byte2 w = 0;
+
+   *out = self->reg;
+   for (w = 0; w < latches->count && latches->writes[w].line <= line; ++w) {
+      ((byte*)out)[latches->writes[w].offset] = latches->writes[w].value;
+   }
+}
+
+boolean snesLatchRegisters(SNES *self, int line, const Registers *regs) {
+   SNESRegisterLatches *latches = &self->latches;
+   Registers current;
+   byte2 count = 0;
+   size_t i = 0;
+
+   if (line < 0 || line >= SNES_SCANLINE_COUNT ||
+      (latches->count && latches->writes[latches->count - 1].line > line)) {
+      return false;
+   }
+
+   _latchedRegisters(self, line, &current);
+
+   for (i = 0; i < sizeof(Registers); ++i) {
+      count += ((const byte*)regs)[i] != ((byte*)&current)[i];
+   }
+   if (latches->count + count > SNES_MAX_REGISTER_WRITES) {
+      return false;
+   }
+
+   for (i = 0; i < sizeof(Registers); ++i) {
+      if (((const byte*)regs)[i] != ((byte*)&current)[i]) {
+         latches->writes[latches->count++] = (SNESRegisterWrite) { (byte)line, (byte)i, ((const byte*)regs)[i] };
+      }
+   }
+
+   return true;
+}
+
+void snesLatchClear(SNES *self) {
+   self->latches.count = 0;
+}
+
+SNESRenderer *snesRendererCreate() {
+   return checkedCalloc(1, sizeof(SNESRenderer));
+}
+
+void snesRendererDestroy(SNESRenderer *self) {
+   checkedFree(self);
+}
+
+void snesRendererInvalidateVRAM(SNESRenderer *self, size_t addr, size_t size) {
+   size_t first = 0, last = 0, c = 0;
+
+   if (!size || addr >= VRAM_SIZE) {
+      return;
+   }
+
+   first = addr / sizeof(Char4);
+   last = MIN(addr + size, VRAM_SIZE) - 1;
+   last /= sizeof(Char4);
+
+   for (c = first; c <= last; ++c) {
+      self->tileCache.valid[c >> 5] &= ~(1u << (c & 31));
+   }
+}
+
+// one bit per pixel of a scanline
+typedef struct {
+   uint32_t bits[SNES_SIZE_X / 32];
+}LineMask;
+
+// all ones where mask has x set, otherwise 0, for and'ing pixels out without a branch
+#define LINE_MASK_CLEAR(mask, x) ((byte2)((((mask)->bits[(x) >> 5] >> ((x) & 31)) & 1) - 1))
+#define LINE_MASK_TEST(mask, x) (((mask)->bits[(x) >> 5] >> ((x) & 31)) & 1)
+
+// sets every bit in [left, right], an empty window when left > right
+static void _windowRange(byte left, byte right, LineMask *out) {
+   int word = 0;
+
+   for (word = 0; word < LEN(out->bits); ++word) {
+      int first = MAX(left, word * 32);
+      int last = MIN(right, word * 32 + 31);
+      uint32_t bits = 0;
+
+      if (first <= last) {
+         bits = 0xFFFFFFFF >> (31 - (last - first));
+         bits <<= first - word * 32;
+      }
+
+      out->bits[word] = bits;
+   }
+}
+
+// merges the two windows the way one layer's window settings ask for
+// a layer with neither window enabled gets an empty mask
+static void _windowCombine(const LineMask windows[2], byte enable1, byte invert1, byte enable2, byte invert2, byte logic, LineMask *out) {
+   int word = 0;
+
+   for (word = 0; word < LEN(out->bits); ++word) {
+      uint32_t w1 = windows[0].bits[word] ^ (invert1 ? 0xFFFFFFFF : 0);
+      uint32_t w2 = windows[1].bits[word] ^ (invert2 ? 0xFFFFFFFF : 0);
+      uint32_t bits = 0;
+
+      if (enable1 && enable2) {
+         switch (logic) {
+         case 0: bits = w1 | w2; break;
+         case 1: bits = w1 & w2; break;
+         case 2: bits = w1 ^ w2; break;
+         case 3: bits = ~(w1 ^ w2); break;
+         }
+      }
+      else if (enable1) {
+         bits = w1;
+      }
+      else if (enable2) {
+         bits = w2;
+      }
+
+      out->bits[word] = bits;
+   }
+}
+
+// one slot of a flattened render list with the line it draws to each screen, either a BG priority or an OBJ priority
+// line pixels are 0 for transparent, otherwise a cgram index, NULL lines are screens the slot isn't on
+// main and sub are the same buffer unless only one screen masks it or it's a hires BG
+// windowed pixels are already cleared out of the lines so resolving never looks at masks
+typedef struct {
+   const byte2 *main, *sub;
+   byte layer; //position in the full render list, color math compares these
+   byte colorMath : 1;
+}LineEntry;
+
+// line with every pixel inside mask cleared, copied into scratch only when the mask isn't empty
+static const byte2 *_maskLine(const byte2 *line, const LineMask *mask, byte2 *scratch) {
+   uint32_t any = 0;
+   int x = 0;
+
+   for (x = 0; x < LEN(mask->bits); ++x) {
+      any |= mask->bits[x];
+   }
+
+   if (!any) {
+      return line;
+   }
+
+   for (x = 0; x < SNES_SIZE_X; ++x) {
+      scratch[x] = line[x] & LINE_MASK_CLEAR(mask, x);
+   }
+
+   return scratch;
+}
+
+// a scanline spans 33 character columns at most when the scroll isnt a multiple of 8
+#define BG_TILE_COLUMNS (SNES_SIZE_X / 8 + 1)
+
+// one 8 pixel character column of a BG scanline with its tile entry already resolved
+// hires columns are a whole 16 pixel wide tile, still 8 pixels of each screen
+typedef struct {
+   byte pixels[2][8]; //the scanline's row with both flips applied, 0 is transparent. [1] is the sub screen's, only in hires
+   byte2 palette;
+   byte priority;
+}BGTileColumn;
+
+// a BG scanline's scroll for each of its screen columns, offset-per-tile can give every column its own
+// column 0 starts at screen x 0, the rest are 8 pixels apart from the layer's fine scroll
+typedef struct {
+   byte2 horz[BG_TILE_COLUMNS], vert[BG_TILE_COLUMNS];
+}BGColumnScroll;
+
+// modes 2, 4 and 6 scroll BG1 and BG2 a column at a time from BG3's tile map
+static boolean _bgUsesOPT(const Registers *r, const ProcessBG *l) {
+   byte mode = r->bgMode.mode;
+   return !l->obj && !l->mode7 && l->bgIdx < 2 && (mode == 2 || mode == 4 || mode == 6);
+}
+
+// the BG3 tile entry covering BG3 pixel (x, y), walked the same way the kernels walk a tile map
+static const Tile *_bg3Tile(SNES *self, const Registers *r, int x, int y) {
+   const TileMap *tMap = (const TileMap*)(self->vram.raw + (r->bgSizeAndTileBase[2].baseAddr << 11));
+   byte tShift = r->bgMode.sizeBG3 ? 4 : 3;
+   byte tileX = (byte)(x >> tShift), tileY = (byte)(y >> tShift);
+
+   tileY &= r->bgSizeAndTileBase[2].sizeY ? 63 : 31;
+   if (tileY >= 32) {
+      tileY &= 31; tMap += r->bgSizeAndTileBase[2].sizeX ? 2 : 1;
+   }
+
+   tileX &= r->bgSizeAndTileBase[2].sizeX ? 63 : 31;
+   if (tileX >= 32) {
+      tileX &= 31; tMap += 1;
+   }
+
+   return tMap->tiles + (tileY * 32 + tileX);
+}
+
+// the two BG3 entries an OPT column reads, horizontal then vertical, mode 4 only reads the first
+// every column after 0 reads the entries one BG3 column to its left
+static byte _optEntries(SNES *self, const Registers *r, int col, const Tile *entries[2]) {
+   int x = (r->bgScroll[2].BG.horzOffset & ~7) + (col - 1) * 8;
+   int y = r->bgScroll[2].BG.vertOffset;
+
+   entries[0] = _bg3Tile(self, r, x, y);
+   if (r->bgMode.mode == 4) {
+      return 1;
+   }
+
+   entries[1] = _bg3Tile(self, r, x, y + 8);
+   return 2;
+}
+
+// decodes BG3's offset rows into the layer's per column scroll once per scanline
+// layers without OPT get their plain scroll in every column so the kernels never check
+static void _bgColumnScroll(SNES *self, const Registers *r, const ProcessBG *l, BGColumnScroll *out) {
+   int col = 0;
+
+   for (col = 0; col < BG_TILE_COLUMNS; ++col) {
+      out->horz[col] = l->horzOffset;
+      out->vert[col] = l->vertOffset;
+   }
+
+   if (!_bgUsesOPT(r, l)) {
+      return;
+   }
+
+   for (col = 1; col < BG_TILE_COLUMNS; ++col) {
+      const Tile *entries[2];
+      byte count = _optEntries(self, r, col, entries);
+      const Tile *horz = entries[0], *vert = count > 1 ? entries[1] : NULL;
+
+      //mode 4's single entry replaces one or the other, bit 15 picks
+      if (count == 1 && horz->opt.applyToVertical) {
+         vert = horz;
+         horz = NULL;
+      }
+
+      //horizontal offsets only move whole columns, the fine scroll stays the layer's own
+      if (horz && (l->bgIdx ? horz->opt.applyToBG2 : horz->opt.applyToBG1)) {
+         out->horz[col] = (horz->opt.offset & ~7) | (l->horzOffset & 7);
+      }
+      if (vert && (l->bgIdx ? vert->opt.applyToBG2 : vert->opt.applyToBG1)) {
+         out->vert[col] = vert->opt.offset;
+      }
+   }
+}
+
+// mode 7 scroll and origin registers are 13-bit two's complement
+static int _m7Signed13(TwosComplement13 v) {
+   return v.twos.sign ? (int)v.twos.integer - 4096 : (int)v.twos.integer;
+}
+
+// scroll minus origin is clipped to 10 bits, keeping the sign
+static int _m7Clip(int v) {
+   return (v & 0x2000) ? (v | ~0x3FF) : (v & 0x3FF);
+}
+
+// Rasterizes one mode 7 scanline, BG1 or the EXTBG BG2 that reads the same pixels with a priority bit
+// the affine start point is worked out once per line then stepped across it in 8.8 fixed point
+static void _rasterizeMode7(SNES *self, const SNESTileCache *cache, const Registers *r, ProcessBG *l, const BGColumnScroll *scroll, int y, byte mosaicSize, byte2 *lines[4]) {
+   int a = (sbyte2)r->mode7Matrix.a.raw;
+   int b = (sbyte2)r->mode7Matrix.b.raw;
+   int c = (sbyte2)r->mode7Matrix.c.raw;
+   int d = (sbyte2)r->mode7Matrix.d.raw;
+   int cx = _m7Signed13(r->mode7Origin.x);
+   int cy = _m7Signed13(r->mode7Origin.y);
+   int ox = _m7Clip(_m7Signed13(r->bgScroll[0].M7.horzOffset) - cx);
+   int oy = _m7Clip(_m7Signed13(r->bgScroll[0].M7.vertOffset) - cy);
+   byte screenOver = r->mode7Settings.screenOver;
+   const byte *tiles = self->vram.mode7.BG1.tiles;
+   byte2 direct = l->colorDepth == 8 && r->colorMathControl.directColorMode ? LINE_DIRECT : 0;
+   int x = 0;
+
+   int sy = y;
+   if (l->mosaic) {
+      sy -= y % (mosaicSize + 1);
+   }
+   if (r->mode7Settings.yFlip) {
+      sy = 255 - sy;
+   }
+
+   //the hardware drops the low 6 bits of each product
+   int startX = ((a * ox) & ~63) + ((b * oy) & ~63) + ((b * sy) & ~63) + (cx << 8);
+   int startY = ((c * ox) & ~63) + ((d * oy) & ~63) + ((d * sy) & ~63) + (cy << 8);
+   int stepX = a, stepY = c;
+
+   //mosaic'd lines only look up the first pixel of each block
+   int block = (l->mosaic && mosaicSize) ? mosaicSize + 1 : 1;
+
+   if (r->mode7Settings.xFlip) {
+      startX += a * 255; startY += c * 255;
+      stepX = -a; stepY = -c;
+   }
+
+   //coordinates first, no branches so the compiler can vectorize it
+   int mapX[SNES_SIZE_X], mapY[SNES_SIZE_X];
+   for (x = 0; x < SNES_SIZE_X; ++x) {
+      mapX[x] = (startX + stepX * x) >> 8;
+      mapY[x] = (startY + stepY * x) >> 8;
+   }
+
+   //then the map and character lookups
+   for (x = 0; x < SNES_SIZE_X; x += block) {
+      int px = mapX[x], py = mapY[x];
+      byte pixel = 0;
+
+      //off the 1024x1024 playing field
+      if ((px | py) & ~0x3FF) {
+         if (screenOver == 2) {
+            lines[0][x] = lines[1][x] = 0;
+            continue;
+         }
+         if (screenOver == 3) {
+            pixel = self->vram.mode7.BG1.characters[0].pixels[(py & 7) * 8 + (px & 7)];
+         }
+         else {
+            px &= 0x3FF; py &= 0x3FF;
+         }
+      }
+
+      if (!((px | py) & ~0x3FF)) {
+         byte tile = tiles[(py >> 3) * 128 + (px >> 3)];
+         pixel = self->vram.mode7.BG1.characters[tile].pixels[(py & 7) * 8 + (px & 7)];
+      }
+
+      if (l->colorDepth == 7) {
+         //EXTBG, the top bit is priority and only the first 128 colors are reachable
+         byte pri = pixel >> 7;
+         lines[pri][x] = pixel & 0x7F;
+         lines[!pri][x] = 0;
+      }
+      else {
+         //mode 7 tiles have no palette bits, direct color only has the pixel
+         lines[0][x] = pixel ? direct | pixel : 0;
+         lines[1][x] = 0;
+      }
+   }
+
+   //the rest of each block copies its first pixel
+   if (block > 1) {
+      for (x = 0; x < SNES_SIZE_X; ++x) {
+         int first = x - x % block;
+         lines[0][x] = lines[0][first];
+         lines[1][x] = lines[1][first];
+      }
+   }
+}
+
+// every BG layer rasterizer, mode 7 included, fills one buffer per priority for a single scanline
+// hires layers fill the sub screen's two as well, lines[2 + priority]
+// r is the scanline's own registers, latches already applied
+// scroll is the layer's per column scroll for the scanline, mode 7 ignores it
+typedef void(*BGKernel)(SNES *self, const SNESTileCache *cache, const Registers *r, ProcessBG *l, const BGColumnScroll *scroll, int y, byte mosaicSize, byte2 *lines[4]);
+
+#include "BGKernel_Impl.h"
+
+// every BG kernel built, X(depth, tSize, mosaic, hires), the dispatch table below is filled from the same list
+// hires modes 5 and 6 only have 2bpp and 4bpp BGs
+#define BG_KERNEL_LIST(X) \
+   X(2, 0, 0, 0) X(2, 0, 1, 0) X(2, 1, 0, 0) X(2, 1, 1, 0) \
+   X(4, 0, 0, 0) X(4, 0, 1, 0) X(4, 1, 0, 0) X(4, 1, 1, 0) \
+   X(8, 0, 0, 0) X(8, 0, 1, 0) X(8, 1, 0, 0) X(8, 1, 1, 0) \
+   X(2, 0, 0, 1) X(2, 0, 1, 1) X(2, 1, 0, 1) X(2, 1, 1, 1) \
+   X(4, 0, 0, 1) X(4, 0, 1, 1) X(4, 1, 0, 1) X(4, 1, 1, 1)
+
+#define BG_KERNEL_NAME(depth, tSize, mosaic, hires) _rasterizeBG_##depth##_##tSize##_##mosaic##_##hires
+
+#define BG_KERNEL_DEFINE(depth, tSize, mosaic, hires) \
+   static void BG_KERNEL_NAME(depth, tSize, mosaic, hires)(SNES *self, const SNESTileCache *cache, const Registers *r, ProcessBG *l, const BGColumnScroll *scroll, int y, byte mosaicSize, byte2 *lines[4]) { \
+      _rasterizeBGKernel(self, cache, r, l, scroll, y, mosaicSize, lines, depth, tSize, mosaic, hires); \
+   }
+BG_KERNEL_LIST(BG_KERNEL_DEFINE)
+#undef BG_KERNEL_DEFINE
+
+// [hires][2bpp, 4bpp, 8bpp][16x16 tiles][mosaic], 8bpp hires is never selected and left NULL
+#define BG_KERNEL_ENTRY(depth, tSize, mosaic, hires) [hires][(depth) >> 2][tSize][mosaic] = &BG_KERNEL_NAME(depth, tSize, mosaic, hires),
+static const BGKernel g_bgKernels[2][3][2][2] = {
+   BG_KERNEL_LIST(BG_KERNEL_ENTRY)
+};
+#undef BG_KERNEL_ENTRY
+
+// picks the kernel for a layer, everything it specializes on is fixed for the scanline
+// a mosaic size of 0 is a 1x1 block so those layers take the plain kernel
+static BGKernel _bgKernelSelect(const ProcessBG *l, byte mosaicSize) {
+   if (l->mode7) {
+      return &_rasterizeMode7;
+   }
+
+   return g_bgKernels[l->hires][l->colorDepth >> 2][l->tSize][l->mosaic && mosaicSize];
+}
+
+// OAM decoded once per frame, every scanline only looks at the sprites bucketed onto it
+typedef struct {
+   int16_t x; //9-bit signed x
+   byte sz;
+}ObjInfo;
+
+typedef struct {
+   byte objTileCountX[2];
+   byte objTileCountY[2];
+   byte2 objChars[2]; //obj character bases in 16-color character steps
+   ObjInfo objs[128];
+
+   //range results, the first 32 sprites on each line in oam order
+   byte lineObjs[SNES_SCANLINE_COUNT][OBJS_PER_LINE];
+   byte lineObjCounts[SNES_SCANLINE_COUNT];
+}ObjFrame;
+
+// sprites are ranged for the whole frame up front so obj size and base come from the first line's registers
+static void _buildObjFrame(SNES *self, const Registers *r, ObjFrame *out) {
+   int obj = 0, y = 0;
+
+   switch (r->objSizeAndBase.objSize) {
+   case 0: out->objTileCountX[0] = 1; out->objTileCountY[0] = 1; out->objTileCountX[1] = 2; out->objTileCountY[1] = 2; break;
+   case 1: out->objTileCountX[0] = 1; out->objTileCountY[0] = 1; out->objTileCountX[1] = 4; out->objTileCountY[1] = 4; break;
+   case 2: out->objTileCountX[0] = 1; out->objTileCountY[0] = 1; out->objTileCountX[1] = 8; out->objTileCountY[1] = 8; break;
+   case 3: out->objTileCountX[0] = 2; out->objTileCountY[0] = 2; out->objTileCountX[1] = 4; out->objTileCountY[1] = 4; break;
+   case 4: out->objTileCountX[0] = 2; out->objTileCountY[0] = 2; out->objTileCountX[1] = 8; out->objTileCountY[1] = 8; break;
+   case 5: out->objTileCountX[0] = 4; out->objTileCountY[0] = 4; out->objTileCountX[1] = 8; out->objTileCountY[1] = 8; break;
+   case 6: out->objTileCountX[0] = 2; out->objTileCountY[0] = 4; out->objTileCountX[1] = 4; out->objTileCountY[1] = 8; break;
+   case 7: out->objTileCountX[0] = 2; out->objTileCountY[0] = 4; out->objTileCountX[1] = 4; out->objTileCountY[1] = 4; break;
+   }
+
+   //we can determine the adresses of the obj characters in vram, in 16-color character steps
+   out->objChars[0] = (r->objSizeAndBase.baseAddr << 14) / sizeof(Char16);
+   out->objChars[1] = out->objChars[0] + ((r->objSizeAndBase.baseGap + 1) << 13) / sizeof(Char16);
+
+   memset(out->lineObjCounts, 0, sizeof(out->lineObjCounts));
+
+   for (obj = 0; obj < 128; ++obj) {
+      Sprite *spr = self->oam.primary + obj;
+      ObjInfo *info = out->objs + obj;
+      byte secondary = *(byte*)&self->oam.secondary[obj >> 2];
+      byte si2 = obj & 3; //obj%4
+      byte x9 = !!(secondary & (1 << (si2 * 2)));
+      byte pxHeight = 0;
+
+      info->sz = !!(secondary & (1 << (si2 * 2 + 1)));
+
+      TwosComplement9 _tX = { 0 };
+      _tX.twos.value = spr->x;
+      _tX.twos.sign = x9;
+      if (_tX.twos.sign) {
+         _tX.twos.unused = ~_tX.twos.unused;
+      }
+      info->x = _tX.raw;
+
+      if (!spr->character) {
+         continue;
+      }
+
+      //sprites wrap off the bottom of the screen back onto the top
+      pxHeight = out->objTileCountY[info->sz] * 8;
+      for (y = 0; y < pxHeight; ++y) {
+         byte line = (byte)(spr->y + y);
+         if (line < SNES_SCANLINE_COUNT && out->lineObjCounts[line] < OBJS_PER_LINE) {
+            out->lineObjs[line][out->lineObjCounts[line]++] = (byte)obj;
+         }
+      }
+   }
+}
+
+// where a frame gets written, either doubled RGBA or the indexed planes
+typedef struct {
+   ColorRGBA *rgba;
+   byte2 *indices;
+   byte *flags;
+   int renderFlags;
+}RenderTarget;
+
+// everything a BG kernel's output depends on besides vram, which can't change mid-frame
+typedef struct {
+   BGColumnScroll scroll;
+   int lineY;
+   byte2 horzOffset;
+   byte baseAddr, charBase, sizeX, sizeY, tSize, colorDepth, hires, direct, mosaicSize;
+}BGLineKey;
+
+// scanline buffers that outlive the scanline, each caller rendering lines in order keeps one
+// the BG lines stay put so the next line can reuse them, bgKeys[i] is what bgLines[i] were rasterized from
+typedef struct {
+   byte2 bgLines[4][4][SNES_SIZE_X];
+   BGLineKey bgKeys[4];
+   boolean bgKeyed[4];
+}ScanlineScratch;
+
+// every scanline inside a vertical mosaic block rasterizes a BG to the same lines, so only the first
+// runs the kernel and the rest keep its lines.  True when the lines in scratch are already the layer's
+static boolean _bgLinesReuse(ScanlineScratch *scratch, const Registers *r, const ProcessBG *l, const BGColumnScroll *scroll, int y) {
+   byte mosaicSize = r->mosaic.size;
+   BGLineKey key;
+
+   //mode 7 lines depend on the matrix too, and without mosaic no two lines match anyway
+   if (l->mode7 || !l->mosaic || !mosaicSize) {
+      scratch->bgKeyed[l->bgIdx] = false;
+      return false;
+   }
+
+   memset(&key, 0, sizeof(key));
+   key.scroll = *scroll;
+   key.lineY = y - y % (mosaicSize + 1);
+   key.horzOffset = l->horzOffset;
+   key.baseAddr = l->baseAddr;
+   key.charBase = l->charBase;
+   key.sizeX = l->sizeX;
+   key.sizeY = l->sizeY;
+   key.tSize = l->tSize;
+   key.colorDepth = l->colorDepth;
+   key.hires = l->hires;
+   key.direct = r->colorMathControl.directColorMode;
+   key.mosaicSize = mosaicSize;
+
+   if (scratch->bgKeyed[l->bgIdx] && !memcmp(&key, &scratch->bgKeys[l->bgIdx], sizeof(key))) {
+      return true;
+   }
+
+   scratch->bgKeys[l->bgIdx] = key;
+   scratch->bgKeyed[l->bgIdx] = true;
+   return false;
+}
+
+// renders a single scanline with its own registers r, reads only from self, renderer, r and objs so any number of lines can be rendered at once
+// scratch belongs to the caller, lines rendered in order through the same scratch share mosaic'd BG lines
+static void _renderScanline(SNES *self, const SNESRenderer *renderer, const Registers *r, const ObjFrame *objs, const RenderTarget *target, ScanlineScratch *scratch, int y) {
+   int x = 0;
+   byte layer = 0, obj = 0;
+   const SNESTileCache *cache = &renderer->tileCache;
+
+   typedef struct {
+      const byte *character;
+      int16_t x;
+      byte y;
+      byte palette : 3, priority : 2, flipX:1, flipY:1;
+   }ObjTile;
+
+   const byte *slObjs = objs->lineObjs[y];//scanline objs, already limited to 32
+   byte objCount = objs->lineObjCounts[y], objTileCount = 0;
+   ObjTile slTiles[OBJ_TILES_PER_LINE];//scanline tiles
+
+   //time, from the range build a list of at most 34 8x8 tiles
+   //iterate reverse order
+   for (obj = objCount - 1; obj < objCount; --obj) {
+      Sprite *spr = self->oam.primary + slObjs[obj];
+      const ObjInfo *info = objs->objs + slObjs[obj];
+      byte sz = info->sz;
+      byte pxHeight = objs->objTileCountY[sz] * 8;
+      int16_t tX = info->x;
+
+      if (tX > -(objs->objTileCountX[sz] * 8) && tX < 256) {
+         byte tileCount = objs->objTileCountX[sz];
+         byte t = 0;
+
+         byte yTileOffset = 0;
+
+
+         byte bot = spr->y + pxHeight - 1;
+         //figure out which vertical tile the scanline is in
+         yTileOffset = objs->objTileCountY[sz] - 1 - ((bot - y) / 8);
+
+         //now if its flipped we need to take the opposite
+         if (spr->flipY) {
+            yTileOffset = objs->objTileCountY[sz] - 1 - yTileOffset;
+         }
+
+         //loop over all horizontal 8x8 tiles and add them
+         for (t = 0; t < tileCount && objTileCount < OBJ_TILES_PER_LINE; ++t) {
+            ObjTile tile = { 0 };
+
+            //get index of character (reverse if flipped
+            byte charIndex = spr->flipX ? spr->character + tileCount - 1 - t : spr->character + t;
+
+            //every yoffset means we have top skip toward to the next row of tiles (16 at atime)
+            charIndex += yTileOffset * 16;
+
+            //now we get to nab the characters from vram
+            tile.character = cache->color16s[(objs->objChars[spr->nameTable] + charIndex) & (SNES_VRAM_CHAR16_COUNT - 1)];
+            tile.flipX = spr->flipX;
+            tile.flipY = spr->flipY;
+            tile.palette = spr->palette;
+            tile.priority = spr->priority;
+            tile.x = tX + (t*8);
+            tile.y = 8 - ((bot - y) - ((bot - y) / 8) * 8) - 1;
+
+            slTiles[objTileCount++] = tile;
+         }
+      }
+   }
+
+   //setup our render list, list is in order of front of screen to back
+   //if .obj then we can use the pixel it found for an obj
+   ProcessBG layers[MAX_RENDER_LAYERS] = { 0 };
+   byte layerCount = 0;
+   _setupBGs(r, layers, &layerCount);
+
+   //the obj pixel for each x, split by obj priority to line up with the obj entries in the render list
+   //tiles are in reverse oam order so drawing them in order lets earlier sprites win priority ties
+   byte2 objLines[4][SNES_SIZE_X];
+   byte objPri[SNES_SIZE_X];
+   memset(objLines, 0, sizeof(objLines));
+   memset(objPri, 0, sizeof(objPri));
+
+   for (obj = 0; obj < objTileCount; ++obj) {
+      ObjTile *t = &slTiles[obj];
+      const byte *row = t->character + (t->flipY ? 7 - t->y : t->y) * 8;
+      byte2 palette = 128 + (t->palette * 16); //magic
+      int start = MAX(0, t->x);
+      int end = MIN(SNES_SIZE_X, t->x + 8);
+
+      for (x = start; x < end; ++x) {
+         byte objX = (byte)(x - t->x);
+         byte palIndex = row[t->flipX ? 7 - objX : objX];
+
+         if (palIndex && t->priority >= objPri[x]) {
+            objLines[objPri[x]][x] = 0;
+            objLines[t->priority][x] = palette + palIndex;
+            objPri[x] = t->priority;
+         }
+      }
+   }
+
+   //the window ranges for this line, every layer's mask is some combination of them
+   LineMask windows[2], objWindow, bgWindows[4];
+   _windowRange(r->windowPosition[0].left, r->windowPosition[0].right, &windows[0]);
+   _windowRange(r->windowPosition[1].left, r->windowPosition[1].right, &windows[1]);
+   _windowCombine(windows,
+      r->windowMaskSettings.win1EnableOBJ, r->windowMaskSettings.win1InvertOBJ,
+      r->windowMaskSettings.win2EnableOBJ, r->windowMaskSettings.win2InvertOBJ,
+      r->windowMaskLogic.obj, &objWindow);
+
+   //each BG is rasterized once regardless of how many times it appears in the render list
+   //then the render list is flattened into the entries that actually draw to each screen
+   //hires BGs have a separate pair of lines for the sub screen after the main screen's
+   boolean interleaved = _lineInterleaved(r);
+   boolean subScreen = r->colorMathControl.enableBGOBJ || interleaved;
+   byte2 (*bgLines)[4][SNES_SIZE_X] = scratch->bgLines;
+   boolean bgDrawn[4] = { 0 };
+   LineEntry entries[MAX_RENDER_LAYERS];
+   byte entryCount = 0;
+   byte2 maskedLines[MAX_RENDER_LAYERS * 2][SNES_SIZE_X];
+   byte maskedCount = 0;
+
+   for (layer = 0; layer < layerCount; ++layer) {
+      ProcessBG *l = layers + layer;
+      const byte2 *line = NULL, *subSource = NULL;
+      const LineMask *window = NULL;
+      boolean onMain = false, onSub = false, mainMask = false, subMask = false;
+
+      if (l->obj) {
+         line = subSource = objLines[l->priority];
+         window = &objWindow;
+         onMain = r->mainScreenDesignation.obj;
+         onSub = r->subScreenDesignation.obj;
+         mainMask = r->mainScreenMasking.obj;
+         subMask = r->subScreenMasking.obj;
+      }
+      else {
+         onMain = l->mainScreen;
+         onSub = l->subScreen;
+
+         if ((onMain || (onSub && subScreen)) && !bgDrawn[l->bgIdx]) {
+            byte2 *bgLine[4] = { bgLines[l->bgIdx][0], bgLines[l->bgIdx][1], bgLines[l->bgIdx][2], bgLines[l->bgIdx][3] };
+            BGColumnScroll scroll;
+            _bgColumnScroll(self, r, l, &scroll);
+            if (!_bgLinesReuse(scratch, r, l, &scroll, y)) {
+               _bgKernelSelect(l, r->mosaic.size)(self, cache, r, l, &scroll, y, r->mosaic.size, bgLine);
+            }
+            _windowCombine(windows, l->win1Enable, l->win1Invert, l->win2Enable, l->win2Invert, l->maskLogic, &bgWindows[l->bgIdx]);
+            bgDrawn[l->bgIdx] = true;
+         }
+
+         line = bgLines[l->bgIdx][l->priority];
+         subSource = l->hires ? bgLines[l->bgIdx][2 + l->priority] : line;
+         window = &bgWindows[l->bgIdx];
+         mainMask = l->mainMask;
+         subMask = l->subMask;
+      }
+
+      const byte2 *mainLine = NULL, *subLine = NULL;
+      if (onMain) {
+         mainLine = mainMask ? _maskLine(line, window, maskedLines[maskedCount++]) : line;
+      }
+      if (onSub && subScreen) {
+         //masked the same way on both screens, the main screen's copy does for both
+         subLine = (mainLine && subSource == line && subMask == mainMask) ? mainLine :
+            subMask ? _maskLine(subSource, window, maskedLines[maskedCount++]) : subSource;
+      }
+
+      if (mainLine || subLine) {
+         entries[entryCount++] = (LineEntry) { .main = mainLine, .sub = subLine, .layer = layer, .colorMath = l->obj ? r->colorMathControl.obj : l->enableColorMath };
+      }
    }
 
-   *bgCount = i;
-}
+   //now to resolve the scanline
+   //define our result form, we ned to know once we're done:
+   //  1. The main screen pixel, a palette index (0-255 for all of cgram) or a LINE_DIRECT color, 0 is the backdrop
+   //  2. Same for sub screen
+   //  3. whether color math applies, how it applies (halved, add/sub) is per frame
+   byte2 mainPIdx[SNES_SIZE_X];
+   byte2 subPIdx[SNES_SIZE_X];
+   byte doColorMath[SNES_SIZE_X];
+
+   //without enableBGOBJ the sub screen is only drawn to be shown interleaved, color math still only sees the backdrop
+   boolean subForMath = r->colorMathControl.enableBGOBJ;
+
+   //which entry each screen's pixel came from
+   byte2 mainTags[SNES_SIZE_X], subTags[SNES_SIZE_X];
+
+   memset(mainPIdx, 0, sizeof(mainPIdx));
+   memset(subPIdx, 0, sizeof(subPIdx));
+   memset(mainTags, 0, sizeof(mainTags));
+   memset(subTags, 0, sizeof(subTags));
+
+   //a single pass down the entries, each line is read once and routed to the screens it draws to
+   for (layer = 0; layer < entryCount; ++layer) {
+      const LineEntry *entry = entries + layer;
+
+      if (entry->main && entry->main == entry->sub) {
+         g_routeLineBoth(entry->main, layer, mainPIdx, mainTags, subPIdx, subTags);
+         continue;
+      }
+      if (entry->main) {
+         g_routeLine(entry->main, layer, mainPIdx, mainTags);
+      }
+      if (entry->sub) {
+         g_routeLine(entry->sub, layer, subPIdx, subTags);
+      }
+   }
 
+   for (x = 0; x < SNES_SIZE_X; ++x) {
+      const LineEntry *mainEntry = entries + mainTags[x];
+      byte subLayer = subPIdx[x] && subForMath ? entries[subTags[x]].layer : 0;//the layer index the subpixel came from
 
-//output is 512x168 32-bit color RGBA
-void snesRender(SNES *self, ColorRGBA *out, int flags) {
-   int x = 0, y = 0;
-   byte layer = 0, obj = 0;
+      doColorMath[x] = mainPIdx[x] && mainEntry->colorMath && subLayer <= mainEntry->layer;
+   }
 
-   for (y = 0; y < SNES_SCANLINE_COUNT; ++y) {
-      //Setup scanline
-      Registers *r = &self->reg;
-
-      int mosaicY = y % (self->reg.mosaic.size + 1);
-
-      //determine the obj tilecounts
-      byte objTileCountX[2] = { 0 };
-      byte objTileCountY[2] = { 0 };
-      byte objCount = 0, objTileCount = 0;
-
-      switch (r->objSizeAndBase.objSize) {
-      case 0: objTileCountX[0] = 1; objTileCountY[0] = 1; objTileCountX[1] = 2; objTileCountY[1] = 2; break;
-      case 1: objTileCountX[0] = 1; objTileCountY[0] = 1; objTileCountX[1] = 4; objTileCountY[1] = 4; break;
-      case 2: objTileCountX[0] = 1; objTileCountY[0] = 1; objTileCountX[1] = 8; objTileCountY[1] = 8; break;
-      case 3: objTileCountX[0] = 2; objTileCountY[0] = 2; objTileCountX[1] = 4; objTileCountY[1] = 4; break;
-      case 4: objTileCountX[0] = 2; objTileCountY[0] = 2; objTileCountX[1] = 8; objTileCountY[1] = 8; break;
-      case 5: objTileCountX[0] = 4; objTileCountY[0] = 4; objTileCountX[1] = 8; objTileCountY[1] = 8; break;
-      case 6: objTileCountX[0] = 2; objTileCountY[0] = 4; objTileCountX[1] = 4; objTileCountY[1] = 8; break;
-      case 7: objTileCountX[0] = 2; objTileCountY[0] = 4; objTileCountX[1] = 4; objTileCountY[1] = 4; break;
-      }
-
-      //we can determine the adresses of the obj characters in vram
-      Char16 *objChars[2];
-      objChars[0] = (Char16*)((byte*)&self->vram + (r->objSizeAndBase.baseAddr << 14));
-      objChars[1] = (Char16*)((byte*)objChars[0] + ((r->objSizeAndBase.baseGap + 1) << 13));
-
-      typedef struct {
-         Char16 character;
-         int16_t x;
-         byte y;
-         byte palette : 3, priority : 2, flipX:1, flipY:1;
-      }ObjTile;
-
-      byte slObjs[OBJS_PER_LINE];//scanline objs
-      ObjTile slTiles[OBJ_TILES_PER_LINE];//scanline tiles
-
-      //range, find the first 32 sprites in the scanline
-      byte secondaryIndex = 0;
-      for (obj = 0; obj < 128  &&  objCount < OBJS_PER_LINE; ++obj) {
-         //determine base don obj height the first 32 objs on this sl
-         Sprite *spr = self->oam.primary + obj;
-         if (!spr->character) {
-            continue;
-         }
+   //the color window limits where color math happens and where the main screen is forced black
+   //  colorMathEnable:  0 always, 1 inside, 2 outside, 3 never
+   //  forceScreenBlack: 0 never, 1 outside, 2 inside, 3 always
+   LineMask forceBlack = { 0 };
+   boolean anyForceBlack = r->colorMathControl.forceScreenBlack != 0;
+   if (r->colorMathControl.colorMathEnable || anyForceBlack) {
+      LineMask colorWindow, mathAllowed;
+      int word = 0;
+
+      _windowCombine(windows,
+         r->windowMaskSettings.win1EnableCol, r->windowMaskSettings.win1InvertCol,
+         r->windowMaskSettings.win2EnableCol, r->windowMaskSettings.win2InvertCol,
+         r->windowMaskLogic.color, &colorWindow);
+
+      for (word = 0; word < LEN(colorWindow.bits); ++word) {
+         uint32_t inside = colorWindow.bits[word];
+         uint32_t allowed[4] = { 0xFFFFFFFF, inside, ~inside, 0 };
+         uint32_t black[4] = { 0, ~inside, inside, 0xFFFFFFFF };
+
+         mathAllowed.bits[word] = allowed[r->colorMathControl.colorMathEnable];
+         forceBlack.bits[word] = black[r->colorMathControl.forceScreenBlack];
+      }
+
+      for (x = 0; x < SNES_SIZE_X; ++x) {
+         doColorMath[x] &= LINE_MASK_TEST(&mathAllowed, x);
+      }
+   }
+
+   if (target->indices) {
+      //leave the colors to the palette shader
+      byte2 *outIdx = target->indices + (y * SNES_SIZE_X);
+      byte *outFlags = target->flags + (y * SNES_SIZE_X);
+      byte mathFlags = SNES_INDEXED_COLOR_MATH;
+      byte backdropFlags = SNES_INDEXED_BACKDROP;
+      byte plainFlags = 0;
+
+      if (r->colorMathControl.addSubtract) { mathFlags |= SNES_INDEXED_SUBTRACT; }
+      if (r->colorMathControl.halve) { mathFlags |= SNES_INDEXED_HALVE; }
+      if (target->renderFlags&SNES_RENDER_DEBUG_WHITE) { backdropFlags |= SNES_INDEXED_BACKDROP_WHITE; }
+      if (interleaved) {
+         //a transparent sub screen shows the same backdrop as the main screen, so every hires pixel needs its color
+         byte hiresFlags = SNES_INDEXED_HIRES | (backdropFlags & SNES_INDEXED_BACKDROP_WHITE);
+         mathFlags |= hiresFlags;
+         backdropFlags |= hiresFlags;
+         plainFlags |= hiresFlags;
+         if (!subForMath) { mathFlags |= SNES_INDEXED_MATH_BACKDROP; }
+      }
 
-         byte si2 = obj & 3; //obj%4
-         byte x9 = !!((*(byte*)&self->oam.secondary[secondaryIndex]) & (1 << (si2 * 2)));
-         byte sz = !!((*(byte*)&self->oam.secondary[secondaryIndex]) & (1 << (si2 * 2 + 1)));         
-         byte pxHeight = objTileCountY[sz] * 8;
-         if (si2 == 3) { ++secondaryIndex; }
+      //direct colors don't fit, snesNeedsDirectColor tells callers to render those frames through snesRender
+      for (x = 0; x < SNES_SIZE_X; ++x) {
+         outIdx[x] = (byte)mainPIdx[x] | ((byte)subPIdx[x] << 8);
+         outFlags[x] = !mainPIdx[x] ? backdropFlags : doColorMath[x] ? mathFlags : plainFlags;
+      }
 
-         if (
-            (spr->y <= y && spr->y + pxHeight > y) || //scanline falls on sprite
-            (spr->y >= 256 - pxHeight && y <  (byte)(spr->y + pxHeight))) { //
-            slObjs[objCount++] = obj;
+      if (anyForceBlack) {
+         for (x = 0; x < SNES_SIZE_X; ++x) {
+            if (LINE_MASK_TEST(&forceBlack, x)) {
+               outFlags[x] = SNES_INDEXED_BACKDROP;
+            }
          }
       }
+      return;
+   }
+
+   const SNESPaletteCache *palette = &renderer->paletteCache;
+   ColorRGBA backdrop = target->renderFlags&SNES_RENDER_DEBUG_WHITE ? (ColorRGBA) {255, 255, 255, 255} : (ColorRGBA) {0, 0, 0, 255};
+   ResolvedLine resolved;
 
-      //time, from the range build a list of at most 34 8x8 tiles
-      //iterate reverse order
-      for (obj = 31; obj < OBJS_PER_LINE; --obj) {
-         Sprite *spr = self->oam.primary + slObjs[obj];  
+   //every lookup happens here, color math and the stores run over the finished arrays
+   for (x = 0; x < SNES_SIZE_X; ++x) {
+      byte2 main = mainPIdx[x], sub = subPIdx[x];
 
-         byte secondaryIndex = slObjs[obj] >> 2;
-         byte si2 = slObjs[obj] & 3; //obj%4
-         byte x9 = !!((*(byte*)&self->oam.secondary[secondaryIndex]) & (1 << (si2 * 2)));
-         byte sz = !!((*(byte*)&self->oam.secondary[secondaryIndex]) & (1 << (si2 * 2 + 1)));
-         byte pxHeight = objTileCountY[sz] * 8;
+      resolved.math[x] = main && doColorMath[x] ? 0xFF : 0;
+      resolved.plain[x] = main ? _lineColor(palette, main) : backdrop;
+      memcpy(&resolved.mainChannels[x], _lineChannels(palette, main), sizeof(uint32_t));
+      memcpy(&resolved.subChannels[x], _lineChannels(palette, subForMath ? sub : 0), sizeof(uint32_t));
 
-         TwosComplement9 _tX = { 0 };
-         _tX.twos.value = spr->x;
-         _tX.twos.sign = x9;
-         if (_tX.twos.sign) {
-            _tX.twos.unused = ~_tX.twos.unused;
+      //each snes pixel is a pair, interleaved lines show the sub screen on its own in the left half
+      //where nothing drew on it that's the backdrop, same as the main screen
+      if (interleaved) {
+         resolved.left[x] = sub ? _lineColor(palette, sub) : backdrop;
+      }
+   }
+
+   if (anyForceBlack) {
+      for (x = 0; x < SNES_SIZE_X; ++x) {
+         if (LINE_MASK_TEST(&forceBlack, x)) {
+            resolved.math[x] = 0;
+            resolved.plain[x] = resolved.left[x] = (ColorRGBA) { 0, 0, 0, 255 };
          }
-         int16_t tX = _tX.raw;
+      }
+   }
 
-         if (obj >= objCount) {
-            continue;
+   g_resolveLine(&resolved, (r->colorMathControl.addSubtract << 1) | r->colorMathControl.halve, interleaved, target->rgba + (y * SNES_SCANLINE_WIDTH));
+}
+
+// 1 bit per Char4 of vram that differs from the lineCache copy
+typedef struct {
+   uint32_t bits[SNES_VRAM_CHAR4_COUNT / 32];
+   boolean any;
+}VRAMChanges;
+
+#define VRAM_DIFF_BLOCK 1024
+
+// diffs vram against the lineCache copy and brings the copy up to date
+static void _vramDiff(SNES *self, SNESLineCache *cache, VRAMChanges *out) {
+   const byte *vram = self->vram.raw;
+   byte *shadow = cache->vram.raw;
+   size_t block = 0, c = 0;
+
+   memset(out, 0, sizeof(VRAMChanges));
+
+   //nearly all of vram is the same frame to frame so compare big blocks first
+   for (block = 0; block < VRAM_SIZE; block += VRAM_DIFF_BLOCK) {
+      if (!memcmp(vram + block, shadow + block, VRAM_DIFF_BLOCK)) {
+         continue;
+      }
+
+      for (c = block / sizeof(Char4); c < (block + VRAM_DIFF_BLOCK) / sizeof(Char4); ++c) {
+         if (memcmp(vram + c * sizeof(Char4), shadow + c * sizeof(Char4), sizeof(Char4))) {
+            out->bits[c >> 5] |= 1u << (c & 31);
          }
+      }
 
-         if (tX > -(objTileCountX[sz] * 8) && tX < 256) {
-            byte tileCount = objTileCountX[sz];
-            byte t = 0;            
+      memcpy(shadow + block, vram + block, VRAM_DIFF_BLOCK);
+      out->any = true;
+   }
+}
 
-            byte yTileOffset = 0;
+// whether any of count Char4s starting at first changed, wrapping around the end of vram
+static boolean _vramChanged(const VRAMChanges *changes, size_t first, size_t count) {
+   size_t i = 0;
 
+   for (i = 0; i < count; ++i) {
+      size_t c = (first + i) & (SNES_VRAM_CHAR4_COUNT - 1);
+      if ((changes->bits[c >> 5] >> (c & 31)) & 1) {
+         return true;
+      }
+   }
 
-            byte bot = spr->y + pxHeight - 1;
-            //figure out which vertical tile the scanline is in
-            yTileOffset = objTileCountY[sz] - 1 - ((bot - y) / 8);
+   return false;
+}
 
-            //now if its flipped we need to take the opposite
-            if (spr->flipY) {
-               yTileOffset = objTileCountY[sz] - 1 - yTileOffset;
-            }
+// whether anything a BG scanline reads changed, the tile entries, every character the kernels will fetch
+// and for offset-per-tile layers the BG3 entries their scroll comes from
+static boolean _bgLineChanged(SNES *self, const Registers *r, const ProcessBG *l, int y, byte mosaicSize, const VRAMChanges *changes) {
+   //mode 7 tiles and characters are spread over the entire first half of vram
+   if (l->mode7) {
+      return _vramChanged(changes, 0, (VRAM_SIZE / 2) / sizeof(Char4));
+   }
 
-            //loop over all horizontal 8x8 tiles and add them
-            for (t = 0; t < tileCount && objTileCount < OBJ_TILES_PER_LINE; ++t) {
-               ObjTile tile = { 0 };
-
-               //get index of character (reverse if flipped
-               byte charIndex = spr->flipX ? spr->character + tileCount - 1 - t : spr->character + t;               
-
-               //every yoffset means we have top skip toward to the next row of tiles (16 at atime)
-               charIndex += yTileOffset * 16;
-
-               //now we get to nab the characters from vram
-               tile.character = *(objChars[spr->nameTable] + charIndex);
-               tile.flipX = spr->flipX;
-               tile.flipY = spr->flipY;
-               tile.palette = spr->palette;
-               tile.priority = spr->priority;
-               tile.x = tX + (t*8);
-               tile.y = 8 - ((bot - y) - ((bot - y) / 8) * 8) - 1;
-                              
-               slTiles[objTileCount++] = tile;
+   if (_bgUsesOPT(r, l)) {
+      int col = 0;
+      for (col = 1; col < BG_TILE_COLUMNS; ++col) {
+         const Tile *entries[2];
+         byte count = _optEntries(self, r, col, entries), i = 0;
+         for (i = 0; i < count; ++i) {
+            if (_vramChanged(changes, ((const byte*)entries[i] - self->vram.raw) / sizeof(Char4), 1)) {
+               return true;
             }
          }
       }
+   }
+
+   //everything below mirrors the fetch in BGKernel_Impl.h
+   size_t charSize = l->colorDepth / 2; //in Char4s
+   size_t charCount = SNES_VRAM_CHAR4_COUNT / charSize;
+   size_t charBase = (l->charBase << 13) / (charSize * sizeof(Char4));
+   const TileMap *tMapBase = (const TileMap*)(self->vram.raw + (l->baseAddr << 11));
+   byte tShift = l->tSize ? 4 : 3, tMask = l->tSize ? 15 : 7;
+   byte colShift = l->hires ? 4 : 3, txShift = l->hires ? 4 : tShift;
+   int lineY = (l->mosaic && mosaicSize) ? y - y % (mosaicSize + 1) : y;
+   BGColumnScroll scroll;
+   int col = 0;
+
+   _bgColumnScroll(self, r, l, &scroll);
+
+   for (col = 0; col < BG_TILE_COLUMNS; ++col) {
+      int colX = ((scroll.horz[col] >> 3) + col) << colShift;
+      int bgY = lineY + scroll.vert[col];
+      const TileMap *tMap = tMapBase;
+
+      byte tileY = (byte)(bgY >> tShift);
+      tileY &= l->sizeY ? 63 : 31;
+      if (tileY >= 32) {
+         tileY &= 31; tMap += l->sizeX ? 2 : 1;
+      }
+
+      byte inTileY = (byte)(bgY & tMask);
+      byte tileX = (byte)(colX >> txShift);
+      tileX &= l->sizeX ? 63 : 31;
+      if (tileX >= 32) {
+         tileX &= 31; tMap += 1;
+      }
+
+      const Tile *t = tMap->tiles + (tileY * 32 + tileX);
+      if (_vramChanged(changes, ((const byte*)t - self->vram.raw) / sizeof(Char4), 1)) {
+         return true;
+      }
+
+      if (!t->tile.character) {
+         continue;
+      }
 
-      //setup our render list, list is in order of front of screen to back
-      //if .obj then we can use the pixel it found for an obj
-      // we'll iterate over this list twice, once for mainscreen, once for subscreen
-      ProcessBG layers[MAX_RENDER_LAYERS] = { 0 };
-      byte layerCount = 0;
-      TileMap *tMaps[MAX_RENDER_LAYERS];
-      Char4 *cMaps[MAX_RENDER_LAYERS];
+      size_t c = charBase + t->tile.character;
+      byte rowY = t->tile.flipY ? tMask - inTileY : inTileY;
+      if (l->tSize && rowY >= 8) {
+         c += 16;
+      }
 
-      _setupBGs(r, layers, &layerCount);
-      for (layer = 0; layer < layerCount; ++layer) {
-         if (!layers[layer].obj) {
-            tMaps[layer] = (TileMap*)((byte*)&self->vram + (layers[layer].baseAddr << 11));
-            cMaps[layer] = (Char4*)((byte*)&self->vram + (layers[layer].charBase << 13));
+      //hires columns read both characters of the tile's row, low res 16x16 only the half under the column
+      if (l->hires) {
+         if (_vramChanged(changes, (c & (charCount - 1)) * charSize, charSize) ||
+             _vramChanged(changes, ((c + 1) & (charCount - 1)) * charSize, charSize)) {
+            return true;
          }
+         continue;
       }
 
-      //now to render the scanline
-      for (x = 0; x < SNES_SIZE_X; ++x) {
-         int mosaicX = x % (self->reg.mosaic.size + 1);
-
-         //start by determining the OBJ Pixel from the scanline obj tile data we gathered
-         boolean objPresent = false;
-         byte objPri = 0, objPalIndex = 0, objPalette = 0;
-         //see if theres an obj here
-         for (obj = 0; obj < objTileCount; ++obj) {
-            ObjTile *t = &slTiles[obj];
-            if (x >= t->x && x < t->x + 8) {
-               byte objX = x - t->x;
-               byte objY = t->y;
-
-               if (t->flipX) { objX = 7 - objX; }
-               if (t->flipY) { objY = 7 - objY; }
-
-               byte palIndex = 0;
-
-               //construct the palette index from the bitplanes
-               palIndex = 
-                  ((t->character.tiles[0].rows[objY].planes[0] & (1 << objX)) >> objX) |
-                  (((t->character.tiles[0].rows[objY].planes[1] & (1 << objX)) >> objX) << 1) |
-                  (((t->character.tiles[1].rows[objY].planes[0] & (1 << objX)) >> objX) << 2) |
-                  (((t->character.tiles[1].rows[objY].planes[1] & (1 << objX)) >> objX) << 3);
-
-               if (palIndex && t->priority >= objPri) {
-                  objPalIndex = palIndex;
-                  objPri = t->priority;
-                  objPalette = t->palette;
-                  objPresent = true;
-               }
+      if (l->tSize) {
+         c += ((colX >> 3) & 1) ^ t->tile.flipX;
+      }
+
+      if (_vramChanged(changes, (c & (charCount - 1)) * charSize, charSize)) {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+// hashes everything about the sprites ranged onto a line, a line whose hash matches last render's has the same sprites
+static uint32_t _objLineSignature(SNES *self, const ObjFrame *objs, int y) {
+   uint32_t hash = 2166136261u;
+   byte obj = 0;
+
+   hash = (hash ^ objs->lineObjCounts[y]) * 16777619u;
+   for (obj = 0; obj < objs->lineObjCounts[y]; ++obj) {
+      byte idx = objs->lineObjs[y][obj];
+      const Sprite *spr = self->oam.primary + idx;
+      const ObjInfo *info = objs->objs + idx;
+
+      hash = (hash ^ idx) * 16777619u;
+      hash = (hash ^ (spr->y | (spr->character << 8) | (spr->nameTable << 16) | (spr->palette << 17) |
+         (spr->priority << 20) | (spr->flipX << 22) | (spr->flipY << 23))) * 16777619u;
+      hash = (hash ^ ((byte2)info->x | (info->sz << 16))) * 16777619u;
+   }
+
+   return hash;
+}
+
+// works out which lines need rendering this frame and brings the lineCache up to date for the next one
+// changes is vram diffed against what the last render saw
+static void _lineCacheUpdate(SNES *self, SNESRenderer *renderer, const Registers *lineRegs, const ObjFrame *objs, const RenderTarget *target, const VRAMChanges *changes, byte *dirty) {
+   SNESLineCache *cache = &renderer->lineCache;
+   ProcessBG layers[MAX_RENDER_LAYERS];
+   byte layerCount = 0, layer = 0;
+   boolean objCharsChanged = false;
+   int y = 0, i = 0;
+
+   const void *buffers[2] = { target->rgba ? (const void*)target->rgba : (const void*)target->indices, target->flags };
+   int renderFlags = target->renderFlags & ~SNES_RENDER_FULL;
+
+   boolean all = !cache->valid || (target->renderFlags & SNES_RENDER_FULL) ||
+      cache->buffers[0] != buffers[0] || cache->buffers[1] != buffers[1] || cache->renderFlags != renderFlags ||
+      (target->rgba && cache->paletteGeneration != renderer->paletteCache.generation);
+
+   if (!all && changes->any) {
+      //sprites aren't traced down to their characters, any change in either name table redraws every line with sprites
+      for (i = 0; i < 2; ++i) {
+         objCharsChanged |= _vramChanged(changes, objs->objChars[i] * (sizeof(Char16) / sizeof(Char4)), 256 * sizeof(Char16) / sizeof(Char4));
+      }
+   }
+
+   cache->dirtyTop = cache->dirtyBottom = 0;
+
+   for (y = 0; y < SNES_SCANLINE_COUNT; ++y) {
+      const Registers *r = lineRegs + y;
+      uint32_t signature = _objLineSignature(self, objs, y);
+      boolean lineDirty = all || signature != cache->objSignatures[y] || memcmp(cache->reg + y, r, sizeof(Registers));
+      cache->objSignatures[y] = signature;
+      cache->reg[y] = *r;
+
+      if (!lineDirty && changes->any) {
+         boolean checked[4] = { 0 };
+         lineDirty = objCharsChanged && objs->lineObjCounts[y];
+         _setupBGs(r, layers, &layerCount);
+
+         for (layer = 0; layer < layerCount && !lineDirty; ++layer) {
+            ProcessBG *l = layers + layer;
+            if (l->obj || checked[l->bgIdx] || !(l->mainScreen || (l->subScreen && (r->colorMathControl.enableBGOBJ || _lineInterleaved(r))))) {
+               continue;
             }
+
+            lineDirty = _bgLineChanged(self, r, l, y, r->mosaic.size, changes);
+            checked[l->bgIdx] = true;
          }
+      }
 
-         //define our result form, we ned to know once we're done:
-         //  1. The main screen palette index (0-255 for all of cgram)
-         //  2. Same for sub screen
-         //  3. color math logic (enabled, halved, add/sub)
-
-         struct {
-            byte mainPIdx;
-            byte subPIdx;
-            byte subLayer;//the layer index the subpixel came from
-            byte doColorMath : 1;
-         } result = { 0 };
-
-         if (r->colorMathControl.enableBGOBJ) {
-            for (layer = 0; layer < layerCount; ++layer) {
-               ProcessBG *l = layers + layer;
-
-               // expecting an OBJ here, if the OBJ we found fits the priority description 
-               // we can check it for clipping and use it
-               if (l->obj) {
-                  if (!r->subScreenDesignation.obj) {
-                     continue;
-                  }
-
-                  if (objPresent && objPri == l->priority) {
-                     result.subPIdx = 128 + (objPalette * 16) + objPalIndex; //magic
-                     result.subLayer = layer;
-                     break;
-                  }
-                  else {
-                     //obj layer skip the rest
-                     continue;
-                  }
-               }
-
-               //now we can insta-skip if bgs are disabled
-               if (!l->subScreen) {
-                  continue;
-               }
-
-               int bgX = x, bgY = y;//makes sense here to work off copies inc ase we need to change them (mosaics)
-
-               if (l->mosaic) {
-                  bgX -= mosaicX;
-                  bgY -= mosaicY;
-               }
-
-               bgX += l->horzOffset;
-               bgY += l->vertOffset;
-
-               //ok now to process a tilemap
-               //first we need to figure out what tile to use, which depends on the width of the tile in pixels
-               byte tileX = (byte)(bgX >> (l->tSize ? 4 : 3)); //divided by 8 or 16
-               byte tileY = (byte)(bgY >> (l->tSize ? 4 : 3));
-
-               //depending on how many tile maps are given to the BG, either point at a different map or wrap around
-               TileMap *tMap = tMaps[layer];
-               tileX &= l->sizeX ? 63 : 31;
-               if (tileX >= 32) {
-                  tileX &= 31; tMap += 1;
-               }
-               tileY &= l->sizeY ? 63 : 31;
-               if (tileY >= 32) {
-                  tileY &= 31;  tMap += l->sizeX ? 2 : 1;
-               }
-
-               //now detemmine which tile we're using
-               Tile *t = tMap->tiles + (tileY * 32 + tileX);
-               if (t->tile.priority != l->priority || !t->tile.character) {
-                  //only draw from this tile if its set to the currenlty-drawn priority
-                  continue;
-               }
-
-               if (l->colorDepth == 2) {
-                  //we know the tile and the position within it, now we need to know the character
-                  Char4 *c = ((Char4*)cMaps[layer]) + t->tile.character;
-                  byte inTileX = (byte)(bgX & (l->tSize ? 15 : 7)); //mod16 or mod8
-                  byte inTileY = (byte)(bgY & (l->tSize ? 15 : 7));
-
-                  byte palIndex = palIndex =
-                     !!(c->rows[inTileY].planes[0] & (1 << inTileX)) |
-                     (!!(c->rows[inTileY].planes[1] & (1 << inTileX)) << 1);
-
-                  if (palIndex) {
-                     result.subPIdx = (t->tile.palette * 16) + palIndex;
-                     result.subLayer = layer;
-                     break;
-                  }
-               }
-               else {
-                  //we know the tile and the position within it, now we need to know the character
-                  Char16 *c = ((Char16*)cMaps[layer]) + t->tile.character;
-
-
-                  byte inTileX = (byte)(bgX & (l->tSize ? 15 : 7)); //mod16 or mod8
-                  byte inTileY = (byte)(bgY & (l->tSize ? 15 : 7));
-
-                  if (l->tSize) {
-                     if (inTileX >= 8) {
-                        inTileX -= 8;
-                        ++c;
-                     }
-                     if (inTileY >= 8) {
-                        inTileY -= 8;
-                        c += 16;
-                     }
-                  }
-
-                  byte palIndex = palIndex =
-                     !!(c->tiles[0].rows[inTileY].planes[0] & (1 << inTileX)) |
-                     (!!(c->tiles[0].rows[inTileY].planes[1] & (1 << inTileX)) << 1) |
-                     (!!(c->tiles[1].rows[inTileY].planes[0] & (1 << inTileX)) << 2) |
-                     (!!(c->tiles[1].rows[inTileY].planes[1] & (1 << inTileX)) << 3);
-
-                  if (palIndex) {
-                     result.subPIdx = (t->tile.palette * 16) + palIndex;
-                     result.subLayer = layer;
-                     break;
-                  }
-               }
-            }
+      dirty[y] = lineDirty;
+      if (lineDirty) {
+         if (cache->dirtyTop == cache->dirtyBottom) {
+            cache->dirtyTop = y;
          }
+         cache->dirtyBottom = y + 1;
+      }
+   }
 
-         for (layer = 0; layer < layerCount; ++layer) {
-            ProcessBG *l = layers + layer;
+   cache->paletteGeneration = renderer->paletteCache.generation;
+   cache->buffers[0] = buffers[0];
+   cache->buffers[1] = buffers[1];
+   cache->renderFlags = renderFlags;
+   cache->valid = true;
+}
 
-            // expecting an OBJ here, if the OBJ we found fits the priority description 
-            // we can check it for clipping and use it
-            if (l->obj) {
-               if (!r->mainScreenDesignation.obj) {
-                  continue;
-               }
-
-               if (objPresent && objPri == l->priority) {
-                  result.mainPIdx = 128 + (objPalette * 16) + objPalIndex; //magic
-                  if (r->colorMathControl.obj && result.subLayer <= layer) {
-                     result.doColorMath = 1;
-                  }
-
-                  break;
-               }
-               else {
-                  //obj layer skip the rest
-                  continue;
-               }               
-            }
+// the frame is split into this many bands per render thread so uneven lines still balance out
+#define BANDS_PER_THREAD 4
 
-            //now we can insta-skip if bgs are disabled
-            if (!l->mainScreen) {
-               continue;
-            }
+typedef struct {
+   SNES *snes;
+   const SNESRenderer *renderer;
+   const Registers *lineRegs;
+   const ObjFrame *objs;
+   const RenderTarget *target;
+   const byte *dirty;
+   int bandCount;
+}RenderBands;
+
+static ThreadPool *g_renderPool = NULL;
+
+static void _renderBand(void *data, int index) {
+   RenderBands *bands = (RenderBands*)data;
+   int first = (index * SNES_SCANLINE_COUNT) / bands->bandCount;
+   int last = ((index + 1) * SNES_SCANLINE_COUNT) / bands->bandCount;
+   ScanlineScratch scratch;
+   int y = 0;
+
+   memset(scratch.bgKeyed, 0, sizeof(scratch.bgKeyed));
+   for (y = first; y < last; ++y) {
+      if (bands->dirty[y]) {
+         _renderScanline(bands->snes, bands->renderer, bands->lineRegs + y, bands->objs, bands->target, &scratch, y);
+      }
+   }
+}
 
-            int bgX = x, bgY = y;//makes sense here to work off copies inc ase we need to change them (mosaics)
+void snesRenderSetThreadCount(int count) {
+   if (g_renderPool) {
+      if (threadPoolGetWorkerCount(g_renderPool) == count - 1) {
+         return;
+      }
 
-            if (l->mosaic) {
-               bgX -= mosaicX;
-               bgY -= mosaicY;
-            }
+      threadPoolDestroy(g_renderPool);
+      g_renderPool = NULL;
+   }
 
-            bgX += l->horzOffset;
-            bgY += l->vertOffset;
+   //the calling thread renders too, so a count of 1 needs no pool at all
+   if (count > 1) {
+      g_renderPool = threadPoolCreate(count - 1);
+   }
+}
 
-            //ok now to process a tilemap
-            //first we need to figure out what tile to use, which depends on the width of the tile in pixels
-            byte tileX = (byte)(bgX >> (l->tSize ? 4 : 3)); //divided by 8 or 16
-            byte tileY = (byte)(bgY >> (l->tSize ? 4 : 3));            
+int snesRenderGetThreadCount() {
+   return g_renderPool ? threadPoolGetWorkerCount(g_renderPool) + 1 : 1;
+}
 
-            //depending on how many tile maps are given to the BG, either point at a different map or wrap around
-            TileMap *tMap = tMaps[layer];
-            tileX &= l->sizeX ? 63 : 31;
-            if (tileX >= 32) {
-               tileX &= 31; tMap += 1;
-            }
-            tileY &= l->sizeY ? 63 : 31;
-            if (tileY >= 32) {
-               tileY &= 31;  tMap += l->sizeX ? 2 : 1;
-            }
+// every line's registers, each an immutable snapshot of reg with the latches up to that line applied
+static void _buildLineRegisters(SNES *self, Registers *out) {
+   const SNESRegisterLatches *latches = &self->latches;
+   Registers current = self->reg;
+   byte2 w = 0;
+   int y = 0;
 
-            //now detemmine which tile we're using
-            Tile *t = tMap->tiles + (tileY * 32 + tileX);
-            if (t->tile.priority != l->priority || !t->tile.character) {
-               //only draw from this tile if its set to the currenlty-drawn priority
-               continue;
-            }
+   for (y = 0; y < SNES_SCANLINE_COUNT; ++y) {
+      for (; w < latches->count && latches->writes[w].line <= y; ++w) {
+         ((byte*)&current)[latches->writes[w].offset] = latches->writes[w].value;
+      }
+      out[y] = current;
+   }
+}
 
-            if (l->colorDepth == 2) {
-               //we know the tile and the position within it, now we need to know the character
-               Char4 *c = ((Char4*)cMaps[layer]) + t->tile.character;
-               byte inTileX = (byte)(bgX & (l->tSize ? 15 : 7)); //mod16 or mod8
-               byte inTileY = (byte)(bgY & (l->tSize ? 15 : 7));
-
-               byte palIndex = palIndex =
-                  !!(c->rows[inTileY].planes[0] & (1 << inTileX)) |
-                  (!!(c->rows[inTileY].planes[1] & (1 << inTileX)) << 1);
-
-               if (palIndex) {
-                  result.mainPIdx = (t->tile.palette * 16) + palIndex;
-                  if (l->enableColorMath && result.subLayer <= layer) {
-                     result.doColorMath = 1;
-                  }
-                  break;
-               }
-            }
-            else {
-               //we know the tile and the position within it, now we need to know the character
-               Char16 *c = ((Char16*)cMaps[layer]) + t->tile.character;
-               
-
-               byte inTileX = (byte)(bgX & (l->tSize ? 15 : 7)); //mod16 or mod8
-               byte inTileY = (byte)(bgY & (l->tSize ? 15 : 7));
-
-               if (l->tSize) {
-                  if (inTileX >= 8) {
-                     inTileX -= 8;
-                     ++c;
-                  }
-                  if (inTileY >= 8) {
-                     inTileY -= 8;
-                     c += 16;
-                  }
-               }
-
-               byte palIndex = palIndex =
-                  !!(c->tiles[0].rows[inTileY].planes[0] & (1 << inTileX)) |
-                  (!!(c->tiles[0].rows[inTileY].planes[1] & (1 << inTileX)) << 1) |
-                  (!!(c->tiles[1].rows[inTileY].planes[0] & (1 << inTileX)) << 2) |
-                  (!!(c->tiles[1].rows[inTileY].planes[1] & (1 << inTileX)) << 3);
-
-               if (palIndex) {
-                  result.mainPIdx = (t->tile.palette * 16) + palIndex;
-                  if (l->enableColorMath && result.subLayer <= layer) {
-                     result.doColorMath = 1;
-                  }
-                  break;
-               }
-            }
+static void _renderFrame(SNES *self, SNESRenderer *renderer, const RenderTarget *target) {
+   ObjFrame objs;
+   Registers lineRegs[SNES_SCANLINE_COUNT];
+   VRAMChanges changes;
+   byte dirty[SNES_SCANLINE_COUNT];
+   int y = 0;
+   size_t i = 0;
+
+   //always diffed so the lineCache copy stays current even on frames that redraw everything
+   //it's also how the tile cache finds every character written since the last render
+   _vramDiff(self, &renderer->lineCache, &changes);
+   if (changes.any) {
+      for (i = 0; i < LEN(changes.bits); ++i) {
+         renderer->tileCache.valid[i] &= ~changes.bits[i];
+      }
+   }
+
+   //the caches are written here only, once rendering starts every line just reads them
+   _tileCacheUpdate(&renderer->tileCache, &self->vram);
+   _paletteCacheUpdate(&renderer->paletteCache, &self->cgram);
+   if (!g_colorMathBuilt) {
+      _colorMathBuild();
+   }
+   if (!g_directColorsBuilt) {
+      _directColorsBuild();
+   }
+   if (!g_resolveLine) {
+      _lineKernelsSelect();
+   }
+   _buildLineRegisters(self, lineRegs);
+   _buildObjFrame(self, lineRegs, &objs);
+   _lineCacheUpdate(self, renderer, lineRegs, &objs, target, &changes, dirty);
+
+   if (renderer->lineCache.dirtyTop == renderer->lineCache.dirtyBottom) {
+      return;
+   }
+
+   if (g_renderPool) {
+      RenderBands bands = { self, renderer, lineRegs, &objs, target, dirty, 0 };
+      bands.bandCount = MIN(SNES_SCANLINE_COUNT, snesRenderGetThreadCount() * BANDS_PER_THREAD);
+      threadPoolRun(g_renderPool, &_renderBand, &bands, bands.bandCount);
+   }
+   else {
+      ScanlineScratch scratch;
+      memset(scratch.bgKeyed, 0, sizeof(scratch.bgKeyed));
+      for (y = 0; y < SNES_SCANLINE_COUNT; ++y) {
+         if (dirty[y]) {
+            _renderScanline(self, renderer, lineRegs + y, &objs, target, &scratch, y);
          }
+      }
+   }
+}
 
+//output is 512x168 32-bit color RGBA
+void snesRender(SNES *self, SNESRenderer *renderer, ColorRGBA *out, int flags) {
+   RenderTarget target = { 0 };
+   target.rgba = out;
+   target.renderFlags = flags;
+   _renderFrame(self, renderer, &target);
+}
 
-         ColorRGBA *outc = out + (y * SNES_SCANLINE_WIDTH) + (x*2);
-         if (result.mainPIdx) {
-            SNESColor subc = self->cgram.colors[result.subPIdx];
-            SNESColor mainc = self->cgram.colors[result.mainPIdx];
-
-            if (result.doColorMath) {
-               byte red, green, blue;
-               if (r->colorMathControl.addSubtract) {
-                  red = mainc.r - subc.r;
-                  green = mainc.g - subc.g;
-                  blue = mainc.b - subc.b;
-               }
-               else {
-                  red = mainc.r + subc.r;
-                  green = mainc.g + subc.g;
-                  blue = mainc.b + subc.b;
-               }
-
-               if (r->colorMathControl.halve) {
-                  red >>= 1;
-                  green >>= 1;
-                  blue >>= 1;
-               }
-
-               mainc.r = MIN(31, MAX(0, red));
-               mainc.g = MIN(31, MAX(0, green));
-               mainc.b = MIN(31, MAX(0, blue));
-            }
+void snesRenderIndexed(SNES *self, SNESRenderer *renderer, byte2 *indices, byte *flags, int renderFlags) {
+   RenderTarget target = { 0 };
+   target.indices = indices;
+   target.flags = flags;
+   target.renderFlags = renderFlags;
+   _renderFrame(self, renderer, &target);
+}
 
-            ColorRGBA color24 = snesColorConverTo24Bit(mainc);
+boolean snesNeedsDirectColor(SNES *self) {
+   const SNESRegisterLatches *latches = &self->latches;
+   Registers current = self->reg;
+   byte2 w = 0;
+   int y = 0;
 
-            *outc = color24;
-            *(outc + 1) = color24;
-         }
-         else {
-            ColorRGBA out = flags&SNES_RENDER_DEBUG_WHITE ? (ColorRGBA) {255, 255, 255, 255} : (ColorRGBA) {0, 0, 0, 255};
+   //walks the latches like _buildLineRegisters without keeping every line
+   for (y = 0; y < SNES_SCANLINE_COUNT; ++y) {
+      const Registers *r = &current;
+      byte mode = 0;
 
-            *outc = out;
-            *(outc + 1) = out;
-         }
+      for (; w < latches->count && latches->writes[w].line <= y; ++w) {
+         ((byte*)&current)[latches->writes[w].offset] = latches->writes[w].value;
+      }
+
+      //BG1 is the only 256 color BG, in modes 3, 4 and 7
+      mode = r->bgMode.mode;
+      if (r->colorMathControl.directColorMode && (mode == 3 || mode == 4 || mode == 7) &&
+         (r->mainScreenDesignation.bg1 || r->subScreenDesignation.bg1)) {
+         return true;
       }
    }
+
+   return false;
 }
 
-typedef struct MapNode MapNode;
+// the cmap keeps one bit per char4 column for each of its rows, set when a subblock covers it
+// finding room is a handful of word ops per row and freeing just clears the bits again, so
+// freed space merges with whatever is free around it without any bookkeeping
+#define CMAP_MAX_ROWS (VRAM_SIZE / BYTES_PER_ROW)
 
 typedef struct {  
    Recti r;
+   Recti origin; //where r was when the cmap's moves were last cleared
    Char4 *data;
-   MapNode *node;
+   boolean dirty; //data or r changed since the last commit
 }CMapSubblock;
 
 struct CMapBlock {
@@ -697,116 +1926,203 @@ struct CMapBlock {
    byte sizeX, sizeY;
    CMapSubblock sb[MAX_SB_COUNT];
    byte sbCount;
+
+   //the vram character of every tile, row-major, rebuilt by the first fill after the block moves
+   byte2 *characters;
+   boolean charactersValid;
 };
 typedef CMapBlock *CMapBlockPtr;
 
 #define VectorT CMapBlockPtr
 #include "libutils/Vector_Create.h"
 
+#define VectorTPart CMapMove
+#include "libutils/Vector_Impl.h"
+
+#define VectorTPart CMapWrite
+#include "libutils/Vector_Impl.h"
+
 static void _cMapBlockDestroy(CMapBlockPtr *self) {
    byte i = 0;
    for (i = 0; i < (*self)->sbCount; ++i) {
       checkedFree((*self)->sb[i].data);
    }
+   checkedFree((*self)->characters);
    checkedFree(*self);
 }
 
-struct MapNode {
-   MapNode *child[2];
-   Recti rect;
-   CMapSubblock *block;
-};
-
-static void _mapNodeDestroy(MapNode *self) {
-   if (self->child[0]) {
-      _mapNodeDestroy(self->child[0]);
-      checkedFree(self->child[0]);
-   }
-   if (self->child[1]) {
-      _mapNodeDestroy(self->child[1]);
-      checkedFree(self->child[1]);
-   }
-}
-
 struct CMap {
-   VRAM *parent;
+   SNES *parent;
    byte baseAddr;
    byte rowOffset;
    byte rowCount;
 
-   MapNode root;
+   uint32_t used[CMAP_MAX_ROWS];
    vec(CMapBlockPtr) *blocks;
 };
 
-CMap *cMapCreate(VRAM *vram, byte baseAddr, byte rowOffset, byte rowCount) {
+CMap *cMapCreate(SNES *snes, byte baseAddr, byte rowOffset, byte rowCount) {
    size_t addr = baseAddr << 13;
    assert(addr + (BYTES_PER_ROW * (rowOffset + rowCount)) <= VRAM_SIZE && "Attempting to create character map outside of vram bounds.");
 
    CMap *out = checkedCalloc(1, sizeof(CMap));
-   out->parent = vram;
+   out->parent = snes;
    out->baseAddr = baseAddr;
    out->rowOffset = rowOffset;
    out->rowCount = rowCount;
    out->blocks = vecCreate(CMapBlockPtr)(&_cMapBlockDestroy);
-   out->root.rect = (Recti) {0, 0, CHAR4_TILES_PER_ROW, rowCount};
 
    return out;
 }
 
 void cMapDestroy(CMap *self) {
-   _mapNodeDestroy(&self->root);
    vecDestroy(CMapBlockPtr)(self->blocks);
    checkedFree(self);
 }
 
-static MapNode *_nodeInsert(MapNode *self, CMapSubblock *block) {
-   
-   //if not a leaf
-   if (self->child[0]) {
-
-      //try inserting into first child
-      MapNode *newNode = _nodeInsert(self->child[0], block);
-      if (newNode) {
-         return newNode;
+static void _cMapMark(CMap *self, const Recti *r, boolean used) {
+   uint32_t mask = (r->w >= CHAR4_TILES_PER_ROW ? 0xFFFFFFFF : (1u << r->w) - 1) << r->x;
+   int y = 0;
+   for (y = r->y; y < r->y + r->h; ++y) {
+      if (used) {
+         self->used[y] |= mask;
+      }
+      else {
+         self->used[y] &= ~mask;
       }
+   }
+}
+
+// finds the topmost, then leftmost, free spot for a w x h rect whose x is a multiple of align
+static boolean _cMapFind(CMap *self, int w, int h, int align, Recti *out) {
+   uint32_t fits[CMAP_MAX_ROWS];
+   uint32_t alignMask = 0;
+   int x = 0, y = 0, i = 0;
 
-      //no room, insert into second child
-      return _nodeInsert(self->child[1], block);
+   if (w <= 0 || w > CHAR4_TILES_PER_ROW || h > self->rowCount) {
+      return false;
    }
-   else {
-      //if theres already a block here, return
-      if (self->block) {
-         return NULL;
+
+   for (x = 0; x < CHAR4_TILES_PER_ROW; x += align) {
+      alignMask |= 1u << x;
+   }
+
+   //bit x of a row's fits is set when the w columns starting at x are all free, each pass
+   //doubles the length of the runs known to be free so wide rects only take a few shifts
+   for (y = 0; y < self->rowCount; ++y) {
+      uint32_t open = ~self->used[y];
+      int run = 1;
+      while (run < w) {
+         int step = MIN(run, w - run);
+         open &= open >> step;
+         run += step;
+      }
+      fits[y] = open & alignMask;
+   }
+
+   for (y = 0; y + h <= self->rowCount; ++y) {
+      uint32_t starts = fits[y];
+      for (i = 1; i < h && starts; ++i) {
+         starts &= fits[y + i];
       }
 
-      //if this isnt big enough, return 
-      if (block->r.w > self->rect.w || block->r.h > self->rect.h) {
-         return NULL;
+      if (starts) {
+         for (x = 0; !(starts & (1u << x)); ++x);
+         *out = (Recti) { x, y, w, h };
+         return true;
       }
+   }
 
-      //if this rect is perfectly sized, accept it
-      if (block->r.w == self->rect.w && block->r.h == self->rect.h) {
-         return self;
+   return false;
+}
+
+// places every subblock of a block or, if one doesnt fit, none of them
+static boolean _cMapPlaceBlock(CMap *self, CMapBlock *block) {
+   byte i = 0;
+   for (i = 0; i < block->sbCount; ++i) {
+      CMapSubblock *sb = &block->sb[i];
+      if (!_cMapFind(self, sb->r.w, sb->r.h, block->colorDepth >> 1, &sb->r)) {
+         while (i--) {
+            _cMapMark(self, &block->sb[i].r, false);
+         }
+         return false;
       }
 
-      //ok at this point we need to split this node
-      self->child[0] = checkedCalloc(1, sizeof(MapNode));
-      self->child[1] = checkedCalloc(1, sizeof(MapNode));
+      _cMapMark(self, &sb->r, true);
+      sb->origin = sb->r;
+      sb->dirty = true;
+   }
+   block->charactersValid = false;
+   return true;
+}
+
+typedef struct {
+   CMapBlock *block;
+   CMapSubblock *sb;
+   int align;
+   Recti old;
+}CMapPacking;
+
+boolean cMapDefrag(CMap *self) {
+   size_t count = 0, i = 0, j = 0;
+   vecForEach(CMapBlockPtr, block, self->blocks, {
+      count += (*block)->sbCount;
+   });
 
-      byte2 dw = self->rect.w - block->r.w;
-      byte2 dh = self->rect.h - block->r.h;
+   if (!count) {
+      return true;
+   }
 
-      if (dw > dh) {
-         self->child[0]->rect = (Recti) { self->rect.x,  self->rect.y, block->r.w, self->rect.h};
-         self->child[1]->rect = (Recti) { self->rect.x + block->r.w, self->rect.y, self->rect.w - block->r.w, self->rect.h};
+   CMapPacking *packing = checkedCalloc(count, sizeof(CMapPacking));
+   vecForEach(CMapBlockPtr, block, self->blocks, {
+      byte s = 0;
+      for (s = 0; s < (*block)->sbCount; ++s) {
+         CMapPacking p = { *block, &(*block)->sb[s], (*block)->colorDepth >> 1, (*block)->sb[s].r };
+
+         //tallest first then widest, ties keep their current order so nothing moves for no reason
+         for (j = i; j > 0; --j) {
+            Recti *o = &packing[j - 1].old;
+            if (o->h > p.old.h || (o->h == p.old.h && (o->w > p.old.w || 
+               (o->w == p.old.w && o->y * CHAR4_TILES_PER_ROW + o->x < p.old.y * CHAR4_TILES_PER_ROW + p.old.x)))) {
+               break;
+            }
+            packing[j] = packing[j - 1];
+         }
+         packing[j] = p;
+         ++i;
       }
-      else {
-         self->child[0]->rect = (Recti) { self->rect.x, self->rect.y, self->rect.w, block->r.h };
-         self->child[1]->rect = (Recti) { self->rect.x, self->rect.y + block->r.h, self->rect.w, self->rect.h - block->r.h };
+   });
+
+   memset(self->used, 0, sizeof(self->used));
+   for (i = 0; i < count; ++i) {
+      CMapSubblock *sb = packing[i].sb;
+      if (!_cMapFind(self, sb->r.w, sb->r.h, packing[i].align, &sb->r)) {
+         break;
       }
+      _cMapMark(self, &sb->r, true);
+   }
 
-      return _nodeInsert(self->child[0], block);
+   //packing tallest first can lose to what was there in rare cases, put everything back if so
+   boolean packed = i == count;
+   if (!packed) {
+      memset(self->used, 0, sizeof(self->used));
+      for (i = 0; i < count; ++i) {
+         packing[i].sb->r = packing[i].old;
+         _cMapMark(self, &packing[i].old, true);
+      }
+   }
+   else {
+      for (i = 0; i < count; ++i) {
+         CMapSubblock *sb = packing[i].sb;
+         if (sb->r.x != packing[i].old.x || sb->r.y != packing[i].old.y) {
+            sb->dirty = true;
+            packing[i].block->charactersValid = false;
+         }
+      }
    }
+
+   checkedFree(packing);
+   return packed;
 }
 
 CMapBlock *cMapAlloc(CMap *cmap, byte colorDepth, byte2 width, byte2 height, byte tileWidth, byte tileHeight) {
@@ -822,6 +2138,9 @@ CMapBlock *cMapAlloc(CMap *cmap, byte colorDepth, byte2 width, byte2 height, byt
    byte char4Width = (tileWidth >> 3) * (colorDepth >> 1); //the number of char4s in one tile
    byte char4Height = tileHeight >> 3;
 
+   //the PPU finds a 16 tall tile's bottom half 16 characters after its top, the next row down only in 16 colors
+   assert((tileHeight == 8 || colorDepth == 4) && "16 pixel tall tiles need a color depth of 4");
+
    // most characters we can fit in one row is 32 char4's
    // split the block into as many subblocks as it needs
    out->sbCount = ((out->width * char4Width) / CHAR4_TILES_PER_ROW) + ((out->width * char4Width) % CHAR4_TILES_PER_ROW > 0 ? 1 : 0);
@@ -837,18 +2156,10 @@ CMapBlock *cMapAlloc(CMap *cmap, byte colorDepth, byte2 width, byte2 height, byt
    if (!out->sb[i].r.w) { out->sb[i].r.w = CHAR4_TILES_PER_ROW; }
    out->sb[i].data = checkedCalloc(1, sizeof(Char4) * out->sb[i].r.w * out->sb[i].r.h);
 
-   for (i = 0; i < out->sbCount; ++i) {
-      MapNode *n = _nodeInsert(&cmap->root, &out->sb[i]);
-      if (n) {
-         n->block = &out->sb[i];
-         n->block->r = n->rect;
-         n->block->node = n;
-      }
-      else {
-         _cMapBlockDestroy(&out);
-         assert(false && "Out of room, cant add block");
-         return NULL;
-      }
+   //defragging here would move blocks whose tilemaps the caller hasn't patched, so leave that to them
+   if (!_cMapPlaceBlock(cmap, out)) {
+      _cMapBlockDestroy(&out);
+      return NULL;
    }
 
    vecPushBack(CMapBlockPtr)(cmap->blocks, &out);
@@ -858,16 +2169,57 @@ CMapBlock *cMapAlloc(CMap *cmap, byte colorDepth, byte2 width, byte2 height, byt
 void cMapFree(CMap *cmap, CMapBlock *block) {
    byte i = 0;
    for (i = 0; i < block->sbCount; ++i) {
-      if (block->sb[i].node) {
-         block->sb[i].node->block = NULL;
-      }
+      _cMapMark(cmap, &block->sb[i].r, false);
    }
    vecRemove(CMapBlockPtr)(cmap->blocks, &block);
 }
 
+// the character index of a char4 column and row of the cmap, counted in characters of the block's depth
+static byte2 _cMapCharacter(CMapBlock *block, int x, int y) {
+   byte charSize = block->colorDepth >> 1; //char4s per character
+   return (byte2)((block->parent->rowOffset + y) * (CHAR4_TILES_PER_ROW / charSize) + x / charSize);
+}
+
+void cMapGetMoves(CMap *self, vec(CMapMove) *out) {
+   vecForEach(CMapBlockPtr, block, self->blocks, {
+      CMapBlock *b = *block;
+      byte charSize = b->colorDepth >> 1;
+      byte i = 0;
+      for (i = 0; i < b->sbCount; ++i) {
+         CMapSubblock *sb = &b->sb[i];
+         int y = 0;
+         if (sb->r.x == sb->origin.x && sb->r.y == sb->origin.y) {
+            continue;
+         }
+
+         //full width subblocks are one run of characters, narrower ones are a run per row
+         if (sb->r.w == CHAR4_TILES_PER_ROW) {
+            CMapMove m = { b, _cMapCharacter(b, sb->origin.x, sb->origin.y), _cMapCharacter(b, sb->r.x, sb->r.y), 
+               (byte2)(sb->r.h * (CHAR4_TILES_PER_ROW / charSize)) };
+            vecPushBack(CMapMove)(out, &m);
+            continue;
+         }
+
+         for (y = 0; y < sb->r.h; ++y) {
+            CMapMove m = { b, _cMapCharacter(b, sb->origin.x, sb->origin.y + y), _cMapCharacter(b, sb->r.x, sb->r.y + y), 
+               (byte2)(sb->r.w / charSize) };
+            vecPushBack(CMapMove)(out, &m);
+         }
+      }
+   });
+}
+
+void cMapClearMoves(CMap *self) {
+   vecForEach(CMapBlockPtr, block, self->blocks, {
+      byte i = 0;
+      for (i = 0; i < (*block)->sbCount; ++i) {
+         (*block)->sb[i].origin = (*block)->sb[i].r;
+      }
+   });
+}
+
 void cMapBlockSetCharacters(CMapBlock *block, Char4 *data) {
    byte char4Width = (block->sizeX >> 3) * (block->colorDepth >> 1); //the number of char4s in one tile
-   byte char4Height = block->sizeY >> 3;
 
    byte i = 0;
    for (i = 0; i < block->sbCount; ++i) {
@@ -875,7 +2227,12 @@ void cMapBlockSetCharacters(CMapBlock *block, Char4 *data) {
       for (y = 0; y < block->sb[i].r.h; ++y) {
          Char4 *destAddr = block->sb[i].data + (block->sb[i].r.w * y);
          Char4 *srcAddr = data + (block->width * char4Width * y) + (CHAR4_TILES_PER_ROW * i);
-         memcpy(destAddr, srcAddr, sizeof(Char4) * block->sb[i].r.w);
+
+         //only rows that actually changed make the subblock go out with the next commit
+         if (memcmp(destAddr, srcAddr, sizeof(Char4) * block->sb[i].r.w)) {
+            memcpy(destAddr, srcAddr, sizeof(Char4) * block->sb[i].r.w);
+            block->sb[i].dirty = true;
+         }
       }
    }
 }
@@ -885,42 +2242,137 @@ byte2 cMapBlockGetCharacter(CMapBlock *block, byte2 x, byte2 y) {
    //based on x, y, colordepth, tilesize, and subblock count
    byte char4Width = (block->sizeX >> 3) * (block->colorDepth >> 1); //the number of char4s in one tile
    byte char4Height = block->sizeY >> 3;
-   byte sbIdx = (x * char4Width) >> 5;
+   int col = x * char4Width;
 
-   CMapSubblock *sb = &block->sb[sbIdx];
+   CMapSubblock *sb = &block->sb[col / CHAR4_TILES_PER_ROW];
+   return _cMapCharacter(block, sb->r.x + col % CHAR4_TILES_PER_ROW, sb->r.y + y * char4Height);
+}
 
-   byte2 out = block->parent->rowOffset * (CHAR4_TILES_PER_ROW / char4Width);
-   out += (sb->r.y + y) * (CHAR4_TILES_PER_ROW/ char4Width);
-   out += sb->r.x / char4Width;
-   out += x- (sbIdx * (CHAR4_TILES_PER_ROW/ char4Width));
-   return out;
+static const byte2 *_cMapBlockCharacters(CMapBlock *block) {
+   if (!block->charactersValid) {
+      byte2 x = 0, y = 0;
+      if (!block->characters) {
+         block->characters = checkedCalloc(block->width * block->height, sizeof(byte2));
+      }
+
+      for (y = 0; y < block->height; ++y) {
+         for (x = 0; x < block->width; ++x) {
+            block->characters[y * block->width + x] = cMapBlockGetCharacter(block, x, y);
+         }
+      }
+      block->charactersValid = true;
+   }
+
+   return block->characters;
 }
 
-static void _commitBlock(CMapBlock *block) {
-   byte char4Width = (block->sizeX >> 3) * (block->colorDepth >> 1); //the number of char4s in one tile
-   byte char4Height = block->sizeY >> 3;
+void cMapBlockFillTileMap(CMapBlock *block, TileMap *maps, boolean sizeX, boolean sizeY,
+   int destX, int destY, int srcX, int srcY, int w, int h, const CMapTileAttributes *attributes) {
+   static const CMapTileAttributes none = { 0 };
+   const CMapTileAttributes *a = attributes ? attributes : &none;
+   const byte2 *characters = _cMapBlockCharacters(block);
+   int maskX = sizeX ? 63 : 31, maskY = sizeY ? 63 : 31;
+   int x = 0, y = 0;
+
+   //clip the source to the block, what's cut off the left and top moves the destination along with it
+   if (srcX < 0) {
+      destX -= srcX;
+      w += srcX;
+      srcX = 0;
+   }
+   if (srcY < 0) {
+      destY -= srcY;
+      h += srcY;
+      srcY = 0;
+   }
+   w = MIN(w, block->width - srcX);
+   h = MIN(h, block->height - srcY);
+   if (w <= 0 || h <= 0) {
+      return;
+   }
+
+   for (y = 0; y < h; ++y) {
+      int tileY = (destY + y) & maskY;
+      int src = (srcY + y) * block->width + srcX;
+
+      //a 64 wide BG's row crosses into the map to its right at most once, fill a map at a time
+      x = 0;
+      while (x < w) {
+         int tileX = (destX + x) & maskX;
+         int count = MIN(w - x, 32 - (tileX & 31));
+         TileMap *map = maps + (tileX >> 5) + (tileY >> 5) * (sizeX ? 2 : 1);
+         Tile *dest = map->tiles + (tileY & 31) * 32 + (tileX & 31);
+         int i = 0;
+
+         for (i = 0; i < count; ++i, ++src) {
+            byte flip = a->flips ? a->flips[src] : a->flip;
+            dest[i].tile.character = characters[src];
+            dest[i].tile.palette = a->palettes ? a->palettes[src] : a->palette;
+            dest[i].tile.priority = a->priorities ? a->priorities[src] : a->priority;
+            dest[i].tile.flipX = flip & 1;
+            dest[i].tile.flipY = (flip >> 1) & 1;
+         }
+
+         x += count;
+      }
+   }
+}
+
+// hands a span of vram a commit wrote to the caller, merged with the last span when they touch
+static void _commitSpan(vec(CMapWrite) *written, size_t addr, size_t size) {
+   CMapWrite *last = NULL;
+
+   if (!written) {
+      return;
+   }
+
+   last = vecIsEmpty(CMapWrite)(written) ? NULL : vecBack(CMapWrite)(written);
+   if (last && last->addr + last->size == addr) {
+      last->size += size;
+   }
+   else {
+      CMapWrite w = { addr, size };
+      vecPushBack(CMapWrite)(written, &w);
+   }
+}
 
-   VRAM *vram = block->parent->parent;
-   Char4 *dest = ((byte*)vram) + (block->parent->baseAddr << 13);
+static void _commitBlock(CMapBlock *block, vec(CMapWrite) *written) {
+   SNES *snes = block->parent->parent;
+   Char4 *dest = (Char4*)(snes->vram.raw + (block->parent->baseAddr << 13));
    dest += block->parent->rowOffset * CHAR4_TILES_PER_ROW;
 
    byte i = 0;
    for (i = 0; i < block->sbCount; ++i) {
       CMapSubblock *sb = &block->sb[i];
       byte2 y = 0;
-      for (y = 0; y < sb->r.h; ++y) {
-         Char4 *destAddr = dest;
-         destAddr += (sb->r.y + (y * char4Height)) * CHAR4_TILES_PER_ROW;
-         destAddr += sb->r.x;
+      if (!sb->dirty) {
+         continue;
+      }
 
-         Char4 *srcAddr = sb->data + (sb->r.w * y);
-         memcpy(destAddr, srcAddr, sizeof(Char4) * sb->r.w);
+      //full width subblocks are contiguous in vram and go in one copy
+      if (sb->r.w == CHAR4_TILES_PER_ROW) {
+         Char4 *destAddr = dest + sb->r.y * CHAR4_TILES_PER_ROW;
+         memcpy(destAddr, sb->data, sizeof(Char4) * sb->r.w * sb->r.h);
+         _commitSpan(written, (byte*)destAddr - snes->vram.raw, sizeof(Char4) * sb->r.w * sb->r.h);
+      }
+      else {
+         for (y = 0; y < sb->r.h; ++y) {
+            Char4 *destAddr = dest;
+            destAddr += (sb->r.y + y) * CHAR4_TILES_PER_ROW;
+            destAddr += sb->r.x;
+
+            Char4 *srcAddr = sb->data + (sb->r.w * y);
+            memcpy(destAddr, srcAddr, sizeof(Char4) * sb->r.w);
+            _commitSpan(written, (byte*)destAddr - snes->vram.raw, sizeof(Char4) * sb->r.w);
+         }
       }
+
+      sb->dirty = false;
    }
 }
 
-void cMapCommit(CMap *self) {
+void cMapCommit(CMap *self, vec(CMapWrite) *written) {
    vecForEach(CMapBlockPtr, block, self->blocks, {
-      _commitBlock(*block);
+      _commitBlock(*block, written);
    });
-}
\ No newline at end of file
+}
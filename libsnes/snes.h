@@ -1,6 +1,7 @@
 #pragma once
 
 #include "libutils/Defs.h"
+#include <stddef.h>
 
 #define SNES_SIZE_X 256
 #define SNES_SIZE_Y 168
@@ -118,9 +119,10 @@ typedef struct {
 
 
       // in 256-color BG's, a Direct-Color-Mode (DCM) register can allow the tile to
-      // repurpose the 13 bits for character and palette for direct BGR color.
+      // repurpose its 3 palette bits for direct BGR color.
       // getting the color out of dcm:
-      // bgr are the LSBs of the colors from byte 0, organized as BBGGGRRR
+      // the character's pixel value is the color, organized as BBGGGRRR
+      // bgr are the LSBs of the colors from the palette bits
       // Together, the 15bit color BBb00:RRRr0:GGGg0
       /* Color c = {0};
          c.r = (dcm.RRR << 2) | (dcm.r << 1);
@@ -437,8 +439,9 @@ typedef struct {
    // Window Mask Settings
    // There are two windows which can define per-scaline masking
    // Each BG (as well as OBJ and "COLOR") can enable or invert each window
-   // If enabled, pixels that fall outside the left and right values of the window (see below) will be ignored
-   // If enabled and inverted, windows ignore every pixel BETWEEN left and right
+   // If enabled, pixels that fall between the left and right values of the window (see above) are masked
+   // If enabled and inverted, every pixel outside of left and right is masked instead
+   // Masks only apply to the screens that enable them in mainScreenMasking/subScreenMasking
    // for information on the "Color Window" see colorMathControl
    struct {
       byte  
@@ -524,10 +527,10 @@ typedef struct {
          colorMathEnable : 2, 
 
          // This allows 1 of 4 options for forcing the screen to black
-         //    0: Always force
-         //    1: Only force when inside the color window
-         //    2: Only force when outside the color window
-         //    3: Never force
+         //    0: Never force
+         //    1: Only force when outside the color window
+         //    2: Only force when inside the color window
+         //    3: Always force
          forceScreenBlack : 2;
 
       // This byte controls what layers partiicpate in Color Math and how it is applied
@@ -555,9 +558,9 @@ typedef struct {
    struct {
       byte screenInterlace : 1, objInterlace : 1, overscanMode : 1, 
          
-         // Modes 4, 5, and 6 utilize a hires mode where the subscreen is shifted a halfdot to the right
+         // Modes 5 and 6 utilize a hires mode where the subscreen is shifted a halfdot to the left
          // and interleaved with the main screen
-         // this bit enables it in all modes,
+         // this bit enables it in all modes, the sub screen is then drawn even without color math
          pseudoHiResMode : 1, 
          
          : 2, 
@@ -571,18 +574,153 @@ typedef struct {
 
 }Registers;
 
+// vram viewed as each of the 3 character sizes
+#define SNES_VRAM_CHAR4_COUNT (sizeof(VRAM) / sizeof(Char4))
+#define SNES_VRAM_CHAR16_COUNT (sizeof(VRAM) / sizeof(Char16))
+#define SNES_VRAM_CHAR256_COUNT (sizeof(VRAM) / sizeof(Char256))
+
+// Every character in vram pre-decoded from bitplanes into one palette index per pixel (row-major, 8x8)
+// BGs and OBJs can point their character bases anywhere so all of vram is decoded at all 3 depths
+// Part of SNESRenderer, brought up to date at the start of every render
+typedef struct {
+   byte color4s[SNES_VRAM_CHAR4_COUNT][8 * 8];
+   byte color16s[SNES_VRAM_CHAR16_COUNT][8 * 8];
+   byte color256s[SNES_VRAM_CHAR256_COUNT][8 * 8];
+
+   // 1 bit per 16 bytes of vram (one Char4), set when every character overlapping it has been decoded
+   // a new renderer starts with the entire cache invalid
+   uint32_t valid[SNES_VRAM_CHAR4_COUNT / 32];
+} SNESTileCache;
+
+// CGRAM pre-converted for output, rebuilt entry by entry when cgram no longer matches the shadow copy
+// Part of SNESRenderer, brought up to date at the start of every render
+typedef struct {
+   ColorRGBA colors[256]; // snesColorConverTo24Bit of every entry
+   byte channels[256][4]; // 5-bit r, g, b of every entry for color math
+
+   SNESColor shadow[256]; // cgram as of the last update
+   uint32_t changed[256 / 32]; // entries that differed in the last update
+   uint32_t generation; // bumped by every update that changed anything, compare to detect palette changes
+   boolean valid;
+} SNESPaletteCache;
+
+// One byte of Registers overwritten when rendering reaches a scanline, the HDMA of this renderer
+// The write stays in effect for every line after it until another write to the same byte
+typedef struct {
+   byte line; // scanline the write takes effect on
+   byte offset; // byte offset into Registers
+   byte value;
+} SNESRegisterWrite;
+
+#define SNES_MAX_REGISTER_WRITES 4096
+
+// Per-scanline register changes for raster effects (scroll gradients, wavy water, per-line windows and color math)
+// Writes are sorted by line, each line renders with reg plus every write at or above it
+// This is PPU state like reg, fill it through snesLatchRegisters and it stays attached until cleared
+typedef struct {
+   SNESRegisterWrite writes[SNES_MAX_REGISTER_WRITES];
+   byte2 count;
+} SNESRegisterLatches;
+
+// What the last render was drawn from, so the next one can skip every scanline whose inputs didn't change
+// Part of SNESRenderer, a new renderer (or one with valid cleared) renders every line
+typedef struct {
+   VRAM vram; // vram as of the last render, diffed 16 bytes at a time against the ranges each line reads
+   Registers reg[SNES_SCANLINE_COUNT]; // every line's registers as of the last render, a line whose registers changed redraws
+   uint32_t objSignatures[SNES_SCANLINE_COUNT]; // hash of the oam entries ranged onto each line
+   uint32_t paletteGeneration; // the paletteCache generation rgba lines were resolved with, indexed lines don't use cgram
+
+   // lines are only skipped when rendering into the same buffers with the same flags
+   const void *buffers[2];
+   int renderFlags;
+   boolean valid;
+
+   // the rows the last render actually wrote, [dirtyTop, dirtyBottom), empty when they're equal
+   // everything outside is whatever was already in the buffers, upload just these rows
+   int dirtyTop, dirtyBottom;
+} SNESLineCache;
+
 typedef struct SNES_t{
    CGRAM cgram;
-   VRAM vram;
+   VRAM vram; // write it freely, every render re-decodes whatever characters changed since the last one
    OAM oam;
    Registers reg;
+   SNESRegisterLatches latches;
 } SNES;
 
-//output is 512x168 32-bit color RGBA
+// Everything kept from one render to the next so the next only redoes what changed, none of it is PPU state
+// Any SNES can be rendered through any renderer, the caches notice when it isn't the one they last saw
+// Keep one per output being drawn so each one's line cache matches what's in its buffers
+typedef struct {
+   SNESTileCache tileCache;
+   SNESPaletteCache paletteCache;
+   SNESLineCache lineCache;
+} SNESRenderer;
+
+SNESRenderer *snesRendererCreate();
+void snesRendererDestroy(SNESRenderer *self);
+
+// Marks a range of vram's decoded characters stale so the next render through self decodes them again
+// Not required, every render diffs vram against what it last rendered and finds direct writes by itself
+void snesRendererInvalidateVRAM(SNESRenderer *self, size_t addr, size_t size);
+
+//output is 512x168 32-bit color RGBA, each snes pixel is a pair
+//on hires lines (modes 5/6 or pseudoHiResMode) the left of the pair is the sub screen and the right the main screen
+enum {
+   SNES_RENDER_DEBUG_WHITE = 1<<0,
+   SNES_RENDER_FULL = 1<<1 //redraw every line even if the lineCache says nothing changed
+};
+void snesRender(SNES *self, SNESRenderer *renderer, ColorRGBA *out, int flags);
+
+// Indexed output, 256x168 with one entry per snes pixel and no colors resolved
+// indices hold the main screen cgram index in the low byte and the sub screen index in the high byte
+// flags hold the SNES_INDEXED_* bits needed to resolve the final color against cgram
+// That's 3 bytes a pixel, about 129KB a frame to upload against snesRender's 344KB, so 2.7x less rather than 4x.
+// Either screen can land on any cgram entry so both indices need all 8 bits, and color math and forced black
+// are decided pixel by pixel by the windows and layers, so there's no room left in a 16-bit texel for them
 enum {
-   SNES_RENDER_DEBUG_WHITE = 1<<0
+   SNES_INDEXED_COLOR_MATH = 1<<0,
+   SNES_INDEXED_SUBTRACT = 1<<1, //only set with COLOR_MATH
+   SNES_INDEXED_HALVE = 1<<2, //only set with COLOR_MATH
+   SNES_INDEXED_BACKDROP = 1<<3, //nothing drew on the main screen, the indices are meaningless
+   SNES_INDEXED_BACKDROP_WHITE = 1<<4, //only set with BACKDROP or HIRES, SNES_RENDER_DEBUG_WHITE was passed
+   SNES_INDEXED_HIRES = 1<<5, //the left half of the pixel is the sub screen index's color on its own, even with BACKDROP
+                              //a sub index of 0 is the backdrop there, white or black like BACKDROP
+   SNES_INDEXED_MATH_BACKDROP = 1<<6 //only set with COLOR_MATH and HIRES, color math uses cgram 0 instead of the sub index
 };
-void snesRender(SNES *self, ColorRGBA *out, int flags);
+void snesRenderIndexed(SNES *self, SNESRenderer *renderer, byte2 *indices, byte *flags, int renderFlags);
+
+// Direct color pixels are 11-bit colors with no cgram index, so indexed output can't hold them
+// True when some line of the frame has a 256 color BG in direct color mode, render it with snesRender instead
+boolean snesNeedsDirectColor(SNES *self);
+
+// Total threads snesRender splits scanline bands across, including the calling thread
+// 1 or less renders serially, output is identical either way
+// The workers are shared by every renderer so only one snesRender may run at a time
+void snesRenderSetThreadCount(int count);
+int snesRenderGetThreadCount();
+
+// Whether the per-line loops may use the SIMD versions the cpu supports, on by default
+// output is identical either way, turning it off is for comparing against the scalar loops
+// Like the thread count this is shared by every renderer, only change it while nothing is rendering
+void snesRenderSetSIMD(boolean allowed);
+// True when SIMD loops are in use, false when they're turned off or the cpu has none
+boolean snesRenderGetSIMD();
+
+// From line onward render with regs instead of whatever was in effect for that line (reg plus earlier latches)
+// Only the bytes that differ are stored, so everything regs leaves alone keeps following reg frame to frame
+// Lines must be latched in increasing order, fails without latching anything if line is out of order
+// or the table can't fit every changed byte
+boolean snesLatchRegisters(SNES *self, int line, const Registers *regs);
+
+// Drops every latch, the whole frame renders with reg again
+void snesLatchClear(SNES *self);
+
+// Snapshots of the PPU state (cgram, vram, oam, registers and latches) for replaying a scene outside the app
+// Only the PPU state is saved, renderers pick up the loaded state on their next render like any other change
+// Loading fails without touching self if the file was written with different struct sizes
+boolean snesSaveState(SNES *self, const char *path);
+boolean snesLoadState(SNES *self, const char *path);
 
 #pragma pack(pop)
 
@@ -591,25 +729,73 @@ typedef struct CMap CMap;
 
 // 'rows' are sets of 32 4-color characters (16 bytes each)
 // baseAddr follows the cmaps baseaddr scheme of 8kb steps (vram + (baseAddr << 13))
-CMap *cMapCreate(VRAM *vram, byte baseAddr, byte rowOffset, byte rowCount);
+CMap *cMapCreate(SNES *snes, byte baseAddr, byte rowOffset, byte rowCount);
 void cMapDestroy(CMap *self);
-void cMapCommit(CMap *self);// push all blocks to vram
+
+// a span of vram bytes a commit wrote, the same addr and size snesRendererInvalidateVRAM takes
+typedef struct {
+   size_t addr, size;
+}CMapWrite;
+
+#define VectorTPart CMapWrite
+#include "libutils/Vector_Decl.h"
+
+// push blocks to vram, only subblocks whose characters or spot changed since their last commit are copied
+// everything written is appended to written unless it's NULL
+void cMapCommit(CMap *self, vec(CMapWrite) *written);
 
 // this is an arbitrarily-sized grid of characters
 // allocated by a CMap.  The CMap will defreg and reorganize this block to make sense in vram
 typedef struct CMapBlock CMapBlock;
 
 // allocates a block of a cmap for writing and use
-// if there is no room, cmap will attempt to defrag to make room
-// if it still cant find space for it it will return null
+// if there is no room it returns null and moves nothing, call cMapDefrag and patch
+// tilemaps from cMapGetMoves before trying again
 // colorDepth is the bitcount for tile color, (2, 4, 8)->(4,16,256)
+// tileWidth and tileHeight are 8 or 16, 16 tall tiles only in 16 colors
 CMapBlock *cMapAlloc(CMap *cmap, byte colorDepth, byte2 width, byte2 height, byte tileWidth, byte tileHeight);
 void cMapFree(CMap *cmap, CMapBlock *block);
 
+// repacks every block toward the top of the cmap so the gaps freed blocks left merge into one
+// blocks keep their characters, the next cMapCommit writes them to vram at their new spots
+// returns false and leaves everything where it was if the blocks wont all fit packed
+boolean cMapDefrag(CMap *self);
+
+// a run of one block's characters that a defrag moved, counted in the units cMapBlockGetCharacter returns
+// tiles that pointed at from + n for n < count should now point at to + n
+typedef struct {
+   CMapBlock *block;
+   byte2 from, to, count;
+}CMapMove;
+
+#define VectorTPart CMapMove
+#include "libutils/Vector_Decl.h"
+
+// appends every run moved since the last cMapClearMoves to out, so tilemaps built from blocks can be patched
+// runs are per block, where blocks freed since have left a run's from may already belong to a newer one
+void cMapGetMoves(CMap *self, vec(CMapMove) *out);
+void cMapClearMoves(CMap *self);
+
 //pushes bitplaned chardata to the block.  The assumption is that data is correctly sized!
+//only the subblocks it actually changes get copied by the next commit
 void cMapBlockSetCharacters(CMapBlock *block, Char4 *data);
 
 // this will take an x,y  for coordinates into the full block and
 // return the correct character index inside vram based on how it is organized
 // x/y can remain consistent regardless of how the CMap reorganizes or splits the blocks
 byte2 cMapBlockGetCharacter(CMapBlock *block, byte2 x, byte2 y);
+
+// the rest of each tile cMapBlockFillTileMap writes, each map holds a byte per tile of the block
+// in the same row-major order as its characters, a NULL map uses the single value after it for every tile
+typedef struct {
+   const byte *palettes, *priorities, *flips; //flips bit 0 is x, bit 1 is y
+   byte palette, priority, flip;
+}CMapTileAttributes;
+
+// writes the w x h tiles of the block starting at (srcX, srcY) into a BG's tilemaps with their top left at (destX, destY)
+// maps is the BG's first TileMap, sizeX/sizeY its bgSizeAndTileBase bits so 64 tile wide or tall BGs span 2 or 4 maps
+// destinations wrap around the BG like scrolling does and the source is clipped to the block
+// characters come from a table the block builds once per move instead of cMapBlockGetCharacter per tile
+// attributes can be NULL for palette 0, priority 0 and no flips
+void cMapBlockFillTileMap(CMapBlock *block, TileMap *maps, boolean sizeX, boolean sizeY,
+   int destX, int destY, int srcX, int srcY, int w, int h, const CMapTileAttributes *attributes);
@@ -1,6 +1,6 @@
 #include "BitTwiddling.h"
 #include "BitBuffer.h"
-#include "libutils\CheckedMemory.h"
+#include "libutils/CheckedMemory.h"
 
 #include <string.h>
 #include <stdint.h>
@@ -145,7 +145,7 @@ byte arrayIsSolid(byte *src, int bitCount){
 #ifdef __GNUC__
    #include <stdlib.h>
    unsigned long BSR32(unsigned long value){
-      return __builtin_clzl(value);
+      return 31 - __builtin_clz((unsigned int)value);
    } 
    void STOSD(unsigned long *dest, unsigned long val, size_t count){
       //TODO: figure out how to do this the ASM way
@@ -0,0 +1,284 @@
+#include "Bitplanes.h"
+
+#include <string.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BITPLANES_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define BITPLANES_TARGET_SSE2
+#define BITPLANES_TARGET_AVX2
+#else
+// gcc only emits vector instructions the function is targeted for
+#define BITPLANES_TARGET_SSE2 __attribute__((target("sse2")))
+#define BITPLANES_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+typedef void(*DecodeFunc)(const byte *planar, int bpp, byte *chunky, size_t count);
+typedef void(*EncodeFunc)(const byte *chunky, int bpp, byte *planar, size_t count);
+
+// picked the first time either direction runs
+static DecodeFunc g_decode = NULL;
+static EncodeFunc g_encode = NULL;
+
+// offset of plane p's byte for row 0 inside a planar character
+#define PLANE_OFFSET(p) (((p) >> 1) * 16 + ((p) & 1))
+
+// spreads the 8 bits of a plane out to one byte per pixel, pixel 0 is the LSB
+// or'ing these together shifted by plane index produces 8 pixels at once
+#define PLANE_EXPAND(v) ( \
+   ((uint64_t)((v) >> 0 & 1) << 0) | ((uint64_t)((v) >> 1 & 1) << 8) | \
+   ((uint64_t)((v) >> 2 & 1) << 16) | ((uint64_t)((v) >> 3 & 1) << 24) | \
+   ((uint64_t)((v) >> 4 & 1) << 32) | ((uint64_t)((v) >> 5 & 1) << 40) | \
+   ((uint64_t)((v) >> 6 & 1) << 48) | ((uint64_t)((v) >> 7 & 1) << 56))
+#define PLANE_EXPAND4(v) PLANE_EXPAND(v), PLANE_EXPAND((v) + 1), PLANE_EXPAND((v) + 2), PLANE_EXPAND((v) + 3)
+#define PLANE_EXPAND16(v) PLANE_EXPAND4(v), PLANE_EXPAND4((v) + 4), PLANE_EXPAND4((v) + 8), PLANE_EXPAND4((v) + 12)
+#define PLANE_EXPAND64(v) PLANE_EXPAND16(v), PLANE_EXPAND16((v) + 16), PLANE_EXPAND16((v) + 32), PLANE_EXPAND16((v) + 48)
+
+static const uint64_t g_planeExpand[256] = {
+   PLANE_EXPAND64(0), PLANE_EXPAND64(64), PLANE_EXPAND64(128), PLANE_EXPAND64(192)
+};
+
+void bitplanesDecodeRow(const byte *planarRow, int bpp, byte *chunky8) {
+   uint64_t row = 0;
+   int p = 0;
+
+   for (p = 0; p < bpp; p += 2) {
+      const byte *pair = planarRow + PLANE_OFFSET(p);
+      row |= g_planeExpand[pair[0]] << p;
+      row |= g_planeExpand[pair[1]] << (p + 1);
+   }
+
+   memcpy(chunky8, &row, sizeof(row));
+}
+
+void bitplanesEncodeRow(const byte *chunky8, int bpp, byte *planarRow) {
+   int p = 0, x = 0;
+
+   for (p = 0; p < bpp; ++p) {
+      byte bits = 0;
+      for (x = 0; x < 8; ++x) {
+         bits |= ((chunky8[x] >> p) & 1) << x;
+      }
+      planarRow[PLANE_OFFSET(p)] = bits;
+   }
+}
+
+static void _decodeScalar(const byte *planar, int bpp, byte *chunky, size_t count) {
+   size_t c = 0;
+   int y = 0;
+
+   for (c = 0; c < count; ++c, planar += BITPLANES_CHAR_SIZE(bpp), chunky += 64) {
+      for (y = 0; y < 8; ++y) {
+         bitplanesDecodeRow(planar + y * 2, bpp, chunky + y * 8);
+      }
+   }
+}
+
+static void _encodeScalar(const byte *chunky, int bpp, byte *planar, size_t count) {
+   size_t c = 0;
+   int y = 0;
+
+   for (c = 0; c < count; ++c, chunky += 64, planar += BITPLANES_CHAR_SIZE(bpp)) {
+      for (y = 0; y < 8; ++y) {
+         bitplanesEncodeRow(chunky + y * 8, bpp, planar + y * 2);
+      }
+   }
+}
+
+#ifdef BITPLANES_X86
+
+// each plane byte is broadcast across 8 lanes, and'ed against the lane's bit and compared
+// the unpacks fan a 16-byte plane pair out so every register covers 2 rows of one plane
+
+BITPLANES_TARGET_SSE2
+static void _decodeSSE2(const byte *planar, int bpp, byte *chunky, size_t count) {
+   const __m128i bitMask = _mm_set_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+   size_t c = 0;
+   int p = 0, i = 0;
+
+   for (c = 0; c < count; ++c, planar += BITPLANES_CHAR_SIZE(bpp), chunky += 64) {
+      __m128i rows[4];
+      for (i = 0; i < 4; ++i) {
+         rows[i] = _mm_setzero_si128();
+      }
+
+      for (p = 0; p < bpp; p += 2) {
+         __m128i block = _mm_loadu_si128((const __m128i*)(planar + p * 8));
+         __m128i lo = _mm_unpacklo_epi8(block, block); //rows 0-3, every byte twice
+         __m128i hi = _mm_unpackhi_epi8(block, block); //rows 4-7
+         __m128i quads[4];
+         __m128i bit0 = _mm_set1_epi8((char)(1 << p));
+         __m128i bit1 = _mm_set1_epi8((char)(2 << p));
+
+         //rows 2i and 2i+1, every byte 4 times
+         quads[0] = _mm_unpacklo_epi16(lo, lo);
+         quads[1] = _mm_unpackhi_epi16(lo, lo);
+         quads[2] = _mm_unpacklo_epi16(hi, hi);
+         quads[3] = _mm_unpackhi_epi16(hi, hi);
+
+         for (i = 0; i < 4; ++i) {
+            __m128i a = _mm_unpacklo_epi32(quads[i], quads[i]); //row 2i, plane p then p+1
+            __m128i b = _mm_unpackhi_epi32(quads[i], quads[i]); //row 2i+1
+            __m128i plane0 = _mm_unpacklo_epi64(a, b);
+            __m128i plane1 = _mm_unpackhi_epi64(a, b);
+
+            plane0 = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(plane0, bitMask), bitMask), bit0);
+            plane1 = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(plane1, bitMask), bitMask), bit1);
+            rows[i] = _mm_or_si128(rows[i], _mm_or_si128(plane0, plane1));
+         }
+      }
+
+      for (i = 0; i < 4; ++i) {
+         _mm_storeu_si128((__m128i*)(chunky + i * 16), rows[i]);
+      }
+   }
+}
+
+// shifting plane p up to each byte's top bit lets movemask gather a whole plane for 2 rows
+BITPLANES_TARGET_SSE2
+static void _encodeSSE2(const byte *chunky, int bpp, byte *planar, size_t count) {
+   size_t c = 0;
+   int p = 0, i = 0;
+
+   for (c = 0; c < count; ++c, chunky += 64, planar += BITPLANES_CHAR_SIZE(bpp)) {
+      for (i = 0; i < 4; ++i) {
+         __m128i rows = _mm_loadu_si128((const __m128i*)(chunky + i * 16));
+
+         for (p = 0; p < bpp; ++p) {
+            int bits = _mm_movemask_epi8(_mm_sll_epi16(rows, _mm_cvtsi32_si128(7 - p)));
+            byte *dest = planar + PLANE_OFFSET(p) + i * 4;
+            dest[0] = (byte)bits;
+            dest[2] = (byte)(bits >> 8);
+         }
+      }
+   }
+}
+
+// same as SSE2 with rows 0-3 in the low lane and 4-7 in the high lane
+BITPLANES_TARGET_AVX2
+static void _decodeAVX2(const byte *planar, int bpp, byte *chunky, size_t count) {
+   const __m256i bitMask = _mm256_set_epi8(
+      -128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1,
+      -128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+   size_t c = 0;
+   int p = 0, i = 0;
+
+   for (c = 0; c < count; ++c, planar += BITPLANES_CHAR_SIZE(bpp), chunky += 64) {
+      //rows 0-1 | 4-5 and rows 2-3 | 6-7
+      __m256i rows[2] = { _mm256_setzero_si256(), _mm256_setzero_si256() };
+
+      for (p = 0; p < bpp; p += 2) {
+         __m128i block = _mm_loadu_si128((const __m128i*)(planar + p * 8));
+         __m256i split = _mm256_inserti128_si256(_mm256_castsi128_si256(block), _mm_srli_si128(block, 8), 1);
+         __m256i doubled = _mm256_unpacklo_epi8(split, split);
+         __m256i quads[2];
+         __m256i bit0 = _mm256_set1_epi8((char)(1 << p));
+         __m256i bit1 = _mm256_set1_epi8((char)(2 << p));
+
+         quads[0] = _mm256_unpacklo_epi16(doubled, doubled);
+         quads[1] = _mm256_unpackhi_epi16(doubled, doubled);
+
+         for (i = 0; i < 2; ++i) {
+            __m256i a = _mm256_unpacklo_epi32(quads[i], quads[i]);
+            __m256i b = _mm256_unpackhi_epi32(quads[i], quads[i]);
+            __m256i plane0 = _mm256_unpacklo_epi64(a, b);
+            __m256i plane1 = _mm256_unpackhi_epi64(a, b);
+
+            plane0 = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(plane0, bitMask), bitMask), bit0);
+            plane1 = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(plane1, bitMask), bitMask), bit1);
+            rows[i] = _mm256_or_si256(rows[i], _mm256_or_si256(plane0, plane1));
+         }
+      }
+
+      _mm256_storeu_si256((__m256i*)chunky, _mm256_permute2x128_si256(rows[0], rows[1], 0x20));
+      _mm256_storeu_si256((__m256i*)(chunky + 32), _mm256_permute2x128_si256(rows[0], rows[1], 0x31));
+   }
+}
+
+BITPLANES_TARGET_AVX2
+static void _encodeAVX2(const byte *chunky, int bpp, byte *planar, size_t count) {
+   size_t c = 0;
+   int p = 0, i = 0, y = 0;
+
+   for (c = 0; c < count; ++c, chunky += 64, planar += BITPLANES_CHAR_SIZE(bpp)) {
+      for (i = 0; i < 2; ++i) {
+         __m256i rows = _mm256_loadu_si256((const __m256i*)(chunky + i * 32));
+
+         for (p = 0; p < bpp; ++p) {
+            uint32_t bits = (uint32_t)_mm256_movemask_epi8(_mm256_sll_epi16(rows, _mm_cvtsi32_si128(7 - p)));
+            byte *dest = planar + PLANE_OFFSET(p) + i * 8;
+            for (y = 0; y < 4; ++y) {
+               dest[y * 2] = (byte)(bits >> (y * 8));
+            }
+         }
+      }
+   }
+}
+
+#ifdef _MSC_VER
+static boolean _cpuHasSSE2() {
+   int info[4];
+   __cpuid(info, 1);
+   return (info[3] & (1 << 26)) != 0;
+}
+
+static boolean _cpuHasAVX2() {
+   int info[4];
+   __cpuid(info, 0);
+   if (info[0] < 7) {
+      return false;
+   }
+
+   //the os has to be saving ymm registers too, osxsave and avx then xcr0 bits 1 and 2
+   __cpuid(info, 1);
+   if ((info[2] & ((1 << 27) | (1 << 28))) != ((1 << 27) | (1 << 28)) || (_xgetbv(0) & 6) != 6) {
+      return false;
+   }
+
+   __cpuidex(info, 7, 0);
+   return (info[1] & (1 << 5)) != 0;
+}
+#else
+static boolean _cpuHasSSE2() { return __builtin_cpu_supports("sse2") != 0; }
+static boolean _cpuHasAVX2() { return __builtin_cpu_supports("avx2") != 0; }
+#endif
+
+#endif
+
+static void _selectKernels() {
+   DecodeFunc decode = &_decodeScalar;
+   EncodeFunc encode = &_encodeScalar;
+
+#ifdef BITPLANES_X86
+   if (_cpuHasAVX2()) {
+      decode = &_decodeAVX2;
+      encode = &_encodeAVX2;
+   }
+   else if (_cpuHasSSE2()) {
+      decode = &_decodeSSE2;
+      encode = &_encodeSSE2;
+   }
+#endif
+
+   g_decode = decode;
+   g_encode = encode;
+}
+
+void bitplanesDecode(const byte *planar, int bpp, byte *chunky, size_t count) {
+   if (!g_decode) {
+      _selectKernels();
+   }
+   g_decode(planar, bpp, chunky, count);
+}
+
+void bitplanesEncode(const byte *chunky, int bpp, byte *planar, size_t count) {
+   if (!g_encode) {
+      _selectKernels();
+   }
+   g_encode(chunky, bpp, planar, count);
+}
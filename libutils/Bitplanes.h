@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Defs.h"
+#include <stddef.h>
+
+// Converts 8x8 characters between planar and chunky (one byte per pixel) layouts
+//
+// Planar characters are built from 16-byte blocks of 2 interleaved bitplanes:
+//    row y is bytes [y*2] (plane n) and [y*2 + 1] (plane n+1), pixel x is bit x of each plane
+// 2bpp characters are one block, 4bpp characters stack 2 (planes 2-3 in the second) and 8bpp stack 4
+// Chunky characters are 64 bytes, row-major
+//
+// Whole characters run through SSE2 or AVX2 when the cpu has them, rows are always scalar
+
+// bpp is 2, 4 or 8
+#define BITPLANES_CHAR_SIZE(bpp) ((bpp) * 8)
+
+// count consecutive planar characters to chunky
+void bitplanesDecode(const byte *planar, int bpp, byte *chunky, size_t count);
+
+// count consecutive chunky characters to planar, pixel bits above bpp are dropped
+void bitplanesEncode(const byte *chunky, int bpp, byte *planar, size_t count);
+
+// a single row, planarRow points at the row's first plane pair inside a character
+// the remaining pairs are read from/written to 16 bytes apart
+void bitplanesDecodeRow(const byte *planarRow, int bpp, byte *chunky8);
+void bitplanesEncodeRow(const byte *chunky8, int bpp, byte *planarRow);
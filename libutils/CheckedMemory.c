@@ -1,10 +1,10 @@
 #include "CheckedMemory.h"
 #include "Strings.h"
-#include "libutils\Defs.h"
+#include "libutils/Defs.h"
 #include <stddef.h>
 #include <stdio.h>
-#include "libutils\BitTwiddling.h"
-#include "libutils\IntrusiveHeap.h"
+#include "libutils/BitTwiddling.h"
+#include "libutils/IntrusiveHeap.h"
 #include <assert.h>
 
 /*this makes our hashtables unchecked*/
@@ -35,7 +35,7 @@ static void freeAllocPQ(){
 }
 
 #define HashTableT FileEntry
-#include "libutils\HashTable_Create.h"
+#include "libutils/HashTable_Create.h"
 
 static int _fileEntryCompare(FileEntry *e1, FileEntry *e2){
    return e1->file == e1->file && e1->line == e2->line;
@@ -71,7 +71,7 @@ typedef struct {
 } adEntry;
 
 #define HashTableT adEntry
-#include "libutils\HashTable_Create.h"
+#include "libutils/HashTable_Create.h"
 
 static int _adEntryCompare(adEntry *e1, adEntry *e2){
    return e1->key == e2->key;
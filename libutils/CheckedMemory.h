@@ -1,8 +1,8 @@
 #pragma once
 
 #include <malloc.h>
-#include "libutils\extern_c.h"
-#include "libutils\DLLBullshit.h"
+#include "libutils/extern_c.h"
+#include "libutils/DLLBullshit.h"
 
 SEXTERN_C
 
@@ -1,6 +1,6 @@
 #include "IntrusiveHeap.h"
-#include "libutils\CheckedMemory.h"
-#include "libutils\Defs.h"
+#include "libutils/CheckedMemory.h"
+#include "libutils/Defs.h"
 
 QueueElem dijkstrasRun(Dijkstras *self){
    while (!priorityQueueIsEmpty(self->queue)){
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "Strings.h"
-#include "libutils\Preprocessor.h"
-#include "libutils\DLLBullshit.h"
+#include "libutils/Preprocessor.h"
+#include "libutils/DLLBullshit.h"
 
 #include <stddef.h>
 
@@ -1,7 +1,7 @@
 #pragma once
 
-#include "libutils\Defs.h"
-#include "libutils\DLLBullshit.h"
+#include "libutils/Defs.h"
+#include "libutils/DLLBullshit.h"
 
 typedef const char* StringView;
 typedef char* MutableStringView;
@@ -0,0 +1,144 @@
+#include "Thread.h"
+#include "CheckedMemory.h"
+
+#ifdef _WIN32
+#include "IncludeWindows.h"
+
+struct Thread_t {
+   HANDLE handle;
+   ThreadFunc func;
+   void *data;
+};
+
+struct Mutex_t {
+   CRITICAL_SECTION cs;
+};
+
+struct Condition_t {
+   CONDITION_VARIABLE cv;
+};
+
+static DWORD WINAPI _threadEntry(LPVOID param) {
+   Thread *self = (Thread*)param;
+   return (DWORD)self->func(self->data);
+}
+
+Thread *threadCreate(ThreadFunc func, void *data) {
+   Thread *out = checkedCalloc(1, sizeof(Thread));
+   out->func = func;
+   out->data = data;
+   out->handle = CreateThread(NULL, 0, &_threadEntry, out, 0, NULL);
+   return out;
+}
+
+int threadJoin(Thread *self) {
+   DWORD result = 0;
+   WaitForSingleObject(self->handle, INFINITE);
+   GetExitCodeThread(self->handle, &result);
+   CloseHandle(self->handle);
+   checkedFree(self);
+   return (int)result;
+}
+
+int threadGetCoreCount() {
+   SYSTEM_INFO info;
+   GetSystemInfo(&info);
+   return MAX(1, (int)info.dwNumberOfProcessors);
+}
+
+Mutex *mutexCreate() {
+   Mutex *out = checkedCalloc(1, sizeof(Mutex));
+   InitializeCriticalSection(&out->cs);
+   return out;
+}
+void mutexDestroy(Mutex *self) {
+   DeleteCriticalSection(&self->cs);
+   checkedFree(self);
+}
+void mutexLock(Mutex *self) { EnterCriticalSection(&self->cs); }
+void mutexUnlock(Mutex *self) { LeaveCriticalSection(&self->cs); }
+
+Condition *conditionCreate() {
+   Condition *out = checkedCalloc(1, sizeof(Condition));
+   InitializeConditionVariable(&out->cv);
+   return out;
+}
+void conditionDestroy(Condition *self) {
+   checkedFree(self);
+}
+void conditionWait(Condition *self, Mutex *mutex) { SleepConditionVariableCS(&self->cv, &mutex->cs, INFINITE); }
+void conditionSignal(Condition *self) { WakeConditionVariable(&self->cv); }
+void conditionBroadcast(Condition *self) { WakeAllConditionVariable(&self->cv); }
+
+#else
+#include <pthread.h>
+#include <unistd.h>
+
+struct Thread_t {
+   pthread_t handle;
+   ThreadFunc func;
+   void *data;
+   int result;
+};
+
+struct Mutex_t {
+   pthread_mutex_t m;
+};
+
+struct Condition_t {
+   pthread_cond_t cv;
+};
+
+static void *_threadEntry(void *param) {
+   Thread *self = (Thread*)param;
+   self->result = self->func(self->data);
+   return NULL;
+}
+
+Thread *threadCreate(ThreadFunc func, void *data) {
+   Thread *out = checkedCalloc(1, sizeof(Thread));
+   out->func = func;
+   out->data = data;
+   pthread_create(&out->handle, NULL, &_threadEntry, out);
+   return out;
+}
+
+int threadJoin(Thread *self) {
+   int result = 0;
+   pthread_join(self->handle, NULL);
+   result = self->result;
+   checkedFree(self);
+   return result;
+}
+
+int threadGetCoreCount() {
+   long count = sysconf(_SC_NPROCESSORS_ONLN);
+   return MAX(1, (int)count);
+}
+
+Mutex *mutexCreate() {
+   Mutex *out = checkedCalloc(1, sizeof(Mutex));
+   pthread_mutex_init(&out->m, NULL);
+   return out;
+}
+void mutexDestroy(Mutex *self) {
+   pthread_mutex_destroy(&self->m);
+   checkedFree(self);
+}
+void mutexLock(Mutex *self) { pthread_mutex_lock(&self->m); }
+void mutexUnlock(Mutex *self) { pthread_mutex_unlock(&self->m); }
+
+Condition *conditionCreate() {
+   Condition *out = checkedCalloc(1, sizeof(Condition));
+   pthread_cond_init(&out->cv, NULL);
+   return out;
+}
+void conditionDestroy(Condition *self) {
+   pthread_cond_destroy(&self->cv);
+   checkedFree(self);
+}
+void conditionWait(Condition *self, Mutex *mutex) { pthread_cond_wait(&self->cv, &mutex->m); }
+void conditionSignal(Condition *self) { pthread_cond_signal(&self->cv); }
+void conditionBroadcast(Condition *self) { pthread_cond_broadcast(&self->cv); }
+
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Defs.h"
+
+typedef struct Thread_t Thread;
+typedef struct Mutex_t Mutex;
+typedef struct Condition_t Condition;
+
+typedef int(*ThreadFunc)(void*);
+
+// starts running func(data) immediately
+Thread *threadCreate(ThreadFunc func, void *data);
+
+// blocks until the thread returns, frees it and returns the result of its func
+int threadJoin(Thread *self);
+
+// number of hardware threads available, at least 1
+int threadGetCoreCount();
+
+Mutex *mutexCreate();
+void mutexDestroy(Mutex *self);
+void mutexLock(Mutex *self);
+void mutexUnlock(Mutex *self);
+
+Condition *conditionCreate();
+void conditionDestroy(Condition *self);
+
+// mutex must be locked by the caller, it is released while waiting and held again on return
+// wakeups can be spurious so always wait in a loop on the actual predicate
+void conditionWait(Condition *self, Mutex *mutex);
+void conditionSignal(Condition *self);
+void conditionBroadcast(Condition *self);
@@ -0,0 +1,139 @@
+#include "ThreadPool.h"
+#include "Thread.h"
+#include "CheckedMemory.h"
+
+struct ThreadPool_t {
+   Thread **workers;
+   int workerCount;
+
+   Mutex *lock;
+   Condition *workReady, *workDone;
+
+   // everything below is guarded by lock
+   ThreadPoolJob job;
+   void *data;
+   int jobCount;
+   int nextJob;
+   int jobsRemaining;
+   unsigned int generation; // bumped per run so sleeping workers can tell new work from a spurious wakeup
+   boolean quit;
+};
+
+// pulls indices until the current run is exhausted, lock must be held and is held again on return
+static void _takeJobs(ThreadPool *self) {
+   while (self->nextJob < self->jobCount) {
+      int index = self->nextJob++;
+      ThreadPoolJob job = self->job;
+      void *data = self->data;
+
+      mutexUnlock(self->lock);
+      job(data, index);
+      mutexLock(self->lock);
+
+      if (--self->jobsRemaining == 0) {
+         conditionBroadcast(self->workDone);
+      }
+   }
+}
+
+static int _workerMain(void *param) {
+   ThreadPool *self = (ThreadPool*)param;
+   unsigned int seen = 0;
+
+   mutexLock(self->lock);
+   seen = self->generation;
+
+   while (true) {
+      while (!self->quit && seen == self->generation) {
+         conditionWait(self->workReady, self->lock);
+      }
+
+      if (self->quit) {
+         break;
+      }
+
+      seen = self->generation;
+      _takeJobs(self);
+   }
+
+   mutexUnlock(self->lock);
+   return 0;
+}
+
+ThreadPool *threadPoolCreate(int workerCount) {
+   ThreadPool *out = checkedCalloc(1, sizeof(ThreadPool));
+   int i = 0;
+
+   out->lock = mutexCreate();
+   out->workReady = conditionCreate();
+   out->workDone = conditionCreate();
+
+   out->workerCount = MAX(0, workerCount);
+   if (out->workerCount) {
+      out->workers = checkedCalloc(out->workerCount, sizeof(Thread*));
+      for (i = 0; i < out->workerCount; ++i) {
+         out->workers[i] = threadCreate(&_workerMain, out);
+      }
+   }
+
+   return out;
+}
+
+void threadPoolDestroy(ThreadPool *self) {
+   int i = 0;
+
+   mutexLock(self->lock);
+   self->quit = true;
+   conditionBroadcast(self->workReady);
+   mutexUnlock(self->lock);
+
+   for (i = 0; i < self->workerCount; ++i) {
+      threadJoin(self->workers[i]);
+   }
+
+   if (self->workers) {
+      checkedFree(self->workers);
+   }
+
+   conditionDestroy(self->workDone);
+   conditionDestroy(self->workReady);
+   mutexDestroy(self->lock);
+   checkedFree(self);
+}
+
+int threadPoolGetWorkerCount(ThreadPool *self) {
+   return self->workerCount;
+}
+
+void threadPoolRun(ThreadPool *self, ThreadPoolJob job, void *data, int count) {
+   int i = 0;
+
+   if (count <= 0) {
+      return;
+   }
+
+   // nothing to hand off, skip the locking entirely
+   if (!self->workerCount || count == 1) {
+      for (i = 0; i < count; ++i) {
+         job(data, i);
+      }
+      return;
+   }
+
+   mutexLock(self->lock);
+   self->job = job;
+   self->data = data;
+   self->jobCount = count;
+   self->nextJob = 0;
+   self->jobsRemaining = count;
+   ++self->generation;
+   conditionBroadcast(self->workReady);
+
+   _takeJobs(self);
+
+   while (self->jobsRemaining) {
+      conditionWait(self->workDone, self->lock);
+   }
+
+   mutexUnlock(self->lock);
+}
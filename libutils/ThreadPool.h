@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Defs.h"
+
+typedef struct ThreadPool_t ThreadPool;
+
+// runs job(data, index) once for every index in [0, count)
+typedef void(*ThreadPoolJob)(void *data, int index);
+
+// workerCount threads are spun up and sleep until work is submitted
+ThreadPool *threadPoolCreate(int workerCount);
+void threadPoolDestroy(ThreadPool *self);
+
+int threadPoolGetWorkerCount(ThreadPool *self);
+
+// blocks until every index has been run, the calling thread takes jobs as well
+// not reentrant, only one thread may be inside threadPoolRun at a time
+void threadPoolRun(ThreadPool *self, ThreadPoolJob job, void *data, int count);
@@ -20,7 +20,7 @@ static size_t _sidEntryHash(SIDEntry *entry) { return entry->key; }
 static void _sidEntryDestroy(SIDEntry *entry) { stringDestroy(entry->val); }
 
 #define HashTableT SIDEntry
-#include "libutils\HashTable_Create.h"
+#include "libutils/HashTable_Create.h"
 
 typedef struct {
    ht(SIDEntry) *entries;
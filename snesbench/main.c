@@ -0,0 +1,1155 @@
+#include "libsnes/snes.h"
+#include "libsnes/DB.h"
+#include "libsnes/DBAssets.h"
+#include "libutils/CheckedMemory.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include "libutils/IncludeWindows.h"
+#else
+#include <time.h>
+#endif
+
+#define DEFAULT_FRAME_COUNT 300
+#define WARMUP_FRAME_COUNT 10
+#define MAX_SCENES 64
+
+// -c renders this many frames of each scene and splits the threaded renders this many ways
+#define CHECK_FRAME_COUNT 4
+#define CHECK_THREAD_COUNT 4
+// and renders this many, a few rounds of every kind of change, when checking the line cache
+#define CHECK_CACHE_FRAME_COUNT 20
+// and churns a cmap with this many allocs and frees, holding at most this many blocks at once
+#define CHECK_CMAP_STEPS 4000
+#define CHECK_CMAP_BLOCKS 32
+
+typedef struct {
+   const char *name;
+   void(*build)(SNES *snes);
+}BuiltinScene;
+
+typedef struct {
+   char name[64];
+   SNES *snes;
+}Scene;
+
+// a block the cmap check has allocated along with the characters it was given
+typedef struct {
+   CMapBlock *block;
+   byte depth, tileWidth, tileHeight;
+   byte2 width, height;
+   Char4 *data; //laid out the way cMapBlockSetCharacters takes it
+   byte2 *characters; //what cMapBlockGetCharacter returned for each tile before the last alloc or defrag
+}CheckBlock;
+
+typedef struct {
+   int frames;
+   int threads;
+   boolean indexed;
+   boolean animate;
+   boolean builtins;
+   const char *dbPath;
+   const char *saveDir;
+   int renderFlags;
+}BenchOptions;
+
+static uint64_t _nowNs() {
+#ifdef _WIN32
+   static LARGE_INTEGER freq = { 0 };
+   LARGE_INTEGER now;
+   if (!freq.QuadPart) {
+      QueryPerformanceFrequency(&freq);
+   }
+   QueryPerformanceCounter(&now);
+   return (uint64_t)((double)now.QuadPart * 1000000000.0 / (double)freq.QuadPart);
+#else
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// scenes are deterministic so runs compare across builds
+static uint32_t g_rngState = 1;
+static void _rngSeed(uint32_t seed) { g_rngState = seed * 2654435761u + 1; }
+static uint32_t _rng() {
+   g_rngState ^= g_rngState << 13;
+   g_rngState ^= g_rngState >> 17;
+   g_rngState ^= g_rngState << 5;
+   return g_rngState;
+}
+
+// random character data with roughly a third of the bytes cleared so transparency shows up
+static void _randomVRAM(SNES *snes) {
+   size_t i = 0;
+   for (i = 0; i < sizeof(VRAM); ++i) {
+      snes->vram.raw[i] = (_rng() % 3) ? (byte)_rng() : 0;
+   }
+}
+
+static void _randomCGRAM(SNES *snes) {
+   int i = 0;
+   for (i = 0; i < 256; ++i) {
+      ((byte2*)&snes->cgram)[i] = (byte2)(_rng() & 0x7FFF);
+   }
+}
+
+static void _randomTileMap(SNES *snes, byte baseAddr) {
+   byte2 *tiles = (byte2*)(snes->vram.raw + (baseAddr << 11));
+   int i = 0;
+   for (i = 0; i < 32 * 32; ++i) {
+      tiles[i] = (byte2)_rng();
+   }
+}
+
+// every sprite somewhere on screen with random sizes, palettes and priorities
+static void _randomOAM(SNES *snes) {
+   int i = 0;
+   for (i = 0; i < 128; ++i) {
+      Sprite *s = &snes->oam.primary[i];
+      s->x = (byte)_rng();
+      s->y = (byte)(_rng() % SNES_SCANLINE_COUNT);
+      s->character = (byte)_rng();
+      s->nameTable = _rng() & 1;
+      s->palette = _rng() & 7;
+      s->priority = _rng() & 3;
+      s->flipX = _rng() & 1;
+      s->flipY = _rng() & 1;
+   }
+   for (i = 0; i < 32; ++i) {
+      byte r = (byte)_rng();
+      memcpy(&snes->oam.secondary[i], &r, 1);
+   }
+}
+
+static void _setTileBases(SNES *snes) {
+   int i = 0;
+   for (i = 0; i < 4; ++i) {
+      snes->reg.bgSizeAndTileBase[i].baseAddr = 24 + i;
+      _randomTileMap(snes, 24 + i);
+   }
+   snes->reg.bgCharBase.bg1 = 0;
+   snes->reg.bgCharBase.bg2 = 1;
+   snes->reg.bgCharBase.bg3 = 2;
+   snes->reg.bgCharBase.bg4 = 2;
+   snes->reg.objSizeAndBase.baseAddr = 1;
+   snes->reg.objSizeAndBase.baseGap = 0;
+}
+
+static void _buildMode1Sprites(SNES *snes) {
+   _randomVRAM(snes);
+   _randomCGRAM(snes);
+   _setTileBases(snes);
+   _randomOAM(snes);
+
+   snes->reg.bgMode.mode = 1;
+   snes->reg.bgMode.m1bg3pri = 1;
+   snes->reg.objSizeAndBase.objSize = OBJSIZE_16x16_32x32;
+
+   snes->reg.mainScreenDesignation.bg1 = 1;
+   snes->reg.mainScreenDesignation.bg2 = 1;
+   snes->reg.mainScreenDesignation.bg3 = 1;
+   snes->reg.mainScreenDesignation.obj = 1;
+}
+
+static void _buildMode0Math(SNES *snes) {
+   _randomVRAM(snes);
+   _randomCGRAM(snes);
+   _setTileBases(snes);
+
+   snes->reg.bgMode.mode = 0;
+
+   snes->reg.mainScreenDesignation.bg1 = 1;
+   snes->reg.mainScreenDesignation.bg2 = 1;
+   snes->reg.subScreenDesignation.bg3 = 1;
+   snes->reg.subScreenDesignation.bg4 = 1;
+
+   snes->reg.colorMathControl.enableBGOBJ = 1;
+   snes->reg.colorMathControl.bg1 = 1;
+   snes->reg.colorMathControl.bg2 = 1;
+   snes->reg.colorMathControl.backDrop = 1;
+   snes->reg.colorMathControl.halve = 1;
+   snes->reg.fixedColorData.r = 8;
+   snes->reg.fixedColorData.b = 16;
+
+   snes->reg.mosaic.enableBG2 = 1;
+   snes->reg.mosaic.size = 3;
+}
+
+static void _buildMode3(SNES *snes) {
+   _randomVRAM(snes);
+   _randomCGRAM(snes);
+   _setTileBases(snes);
+   _randomOAM(snes);
+
+   snes->reg.bgMode.mode = 3;
+   snes->reg.objSizeAndBase.objSize = OBJSIZE_8x8_16x16;
+
+   snes->reg.mainScreenDesignation.bg1 = 1;
+   snes->reg.mainScreenDesignation.obj = 1;
+   snes->reg.subScreenDesignation.bg2 = 1;
+
+   snes->reg.colorMathControl.enableBGOBJ = 1;
+   snes->reg.colorMathControl.bg1 = 1;
+   snes->reg.colorMathControl.obj = 1;
+   snes->reg.colorMathControl.addSubtract = 1;
+}
+
+// the 8bpp BG1 as a full-color backdrop, colors straight from the pixels with no cgram
+static void _buildMode3Direct(SNES *snes) {
+   _buildMode3(snes);
+   snes->reg.colorMathControl.directColorMode = 1;
+}
+
+static void _buildMode7(SNES *snes) {
+   double angle = 0.5, scale = 0.75;
+
+   _randomVRAM(snes);
+   _randomCGRAM(snes);
+   _randomOAM(snes);
+
+   snes->reg.bgMode.mode = 7;
+   snes->reg.objSizeAndBase.baseAddr = 2;
+   snes->reg.objSizeAndBase.objSize = OBJSIZE_8x8_16x16;
+
+   snes->reg.mode7Matrix.a.raw = (byte2)(sbyte2)(cos(angle) * scale * 256.0);
+   snes->reg.mode7Matrix.b.raw = (byte2)(sbyte2)(sin(angle) * scale * 256.0);
+   snes->reg.mode7Matrix.c.raw = (byte2)(sbyte2)(-sin(angle) * scale * 256.0);
+   snes->reg.mode7Matrix.d.raw = (byte2)(sbyte2)(cos(angle) * scale * 256.0);
+   snes->reg.mode7Origin.x.raw = 128;
+   snes->reg.mode7Origin.y.raw = 84;
+   snes->reg.mode7Settings.screenOver = 2;
+
+   snes->reg.mainScreenDesignation.bg1 = 1;
+   snes->reg.mainScreenDesignation.obj = 1;
+}
+
+static void _buildMode1Windows(SNES *snes) {
+   _buildMode1Sprites(snes);
+
+   snes->reg.windowPosition[0].left = 40;
+   snes->reg.windowPosition[0].right = 180;
+   snes->reg.windowPosition[1].left = 100;
+   snes->reg.windowPosition[1].right = 240;
+
+   snes->reg.windowMaskSettings.win1EnableBG1 = 1;
+   snes->reg.windowMaskSettings.win2EnableBG1 = 1;
+   snes->reg.windowMaskSettings.win2InvertBG1 = 1;
+   snes->reg.windowMaskSettings.win1EnableOBJ = 1;
+   snes->reg.windowMaskSettings.win2EnableCol = 1;
+   snes->reg.windowMaskLogic.bg1 = 2;
+   snes->reg.mainScreenMasking.bg1 = 1;
+   snes->reg.mainScreenMasking.obj = 1;
+
+   snes->reg.subScreenDesignation.bg2 = 1;
+   snes->reg.colorMathControl.enableBGOBJ = 1;
+   snes->reg.colorMathControl.colorMathEnable = 1;
+   snes->reg.colorMathControl.bg1 = 1;
+   snes->reg.colorMathControl.bg3 = 1;
+}
+
+// every BG mid mosaic transition, like Game's testMosaic slider
+static void _buildMode1Mosaic(SNES *snes) {
+   _buildMode1Sprites(snes);
+
+   snes->reg.mosaic.enableBG1 = 1;
+   snes->reg.mosaic.enableBG2 = 1;
+   snes->reg.mosaic.enableBG3 = 1;
+   snes->reg.mosaic.size = 7;
+}
+
+// per-line BG1 scroll wave and a circular window, all through register latches
+static void _buildMode1Wavy(SNES *snes) {
+   Registers regs;
+   int y = 0;
+
+   _buildMode1Sprites(snes);
+
+   snes->reg.windowMaskSettings.win1EnableBG2 = 1;
+   snes->reg.windowMaskSettings.win1InvertBG2 = 1;
+   snes->reg.mainScreenMasking.bg2 = 1;
+
+   regs = snes->reg;
+   for (y = 0; y < SNES_SCANLINE_COUNT; ++y) {
+      double dy = (y - SNES_SCANLINE_COUNT / 2) / 64.0;
+      int halfWidth = dy * dy < 1.0 ? (int)(sqrt(1.0 - dy * dy) * 64.0) : -1;
+
+      regs.bgScroll[0].BG.horzOffset = (byte2)(int)(sin(y / 8.0) * 6.0 + 16.0);
+      regs.windowPosition[0].left = halfWidth < 0 ? 255 : (byte)(128 - halfWidth);
+      regs.windowPosition[0].right = halfWidth < 0 ? 0 : (byte)(128 + halfWidth);
+      snesLatchRegisters(snes, y, &regs);
+   }
+}
+
+// 512 wide BG1 and BG2 on both screens, the sub screen fills the even half of every pixel
+static void _buildMode5Hires(SNES *snes) {
+   _buildMode1Sprites(snes);
+   snes->reg.bgMode.mode = 5;
+
+   snes->reg.subScreenDesignation.bg1 = 1;
+   snes->reg.subScreenDesignation.bg2 = 1;
+   snes->reg.subScreenDesignation.obj = 1;
+}
+
+// offset-per-tile column wave on BG1 and BG2, BG3's first two map rows are the horizontal and vertical offsets
+static void _buildMode2Columns(SNES *snes) {
+   Tile *opt = NULL;
+   int col = 0;
+
+   _buildMode1Sprites(snes);
+   snes->reg.bgMode.mode = 2;
+
+   opt = (Tile*)(snes->vram.raw + (snes->reg.bgSizeAndTileBase[2].baseAddr << 11));
+   for (col = 0; col < 32; ++col) {
+      Tile *horz = opt + col, *vert = opt + 32 + col;
+
+      memset(horz, 0, sizeof(Tile));
+      horz->opt.offset = (byte2)(col * 8 + 16);
+      horz->opt.applyToBG2 = 1;
+
+      memset(vert, 0, sizeof(Tile));
+      vert->opt.offset = (byte2)(int)(sin(col / 4.0) * 24.0 + 24.0);
+      vert->opt.applyToBG1 = 1;
+      vert->opt.applyToBG2 = col & 1;
+   }
+}
+
+static const BuiltinScene g_builtins[] = {
+   { "mode1_sprites", &_buildMode1Sprites },
+   { "mode0_math", &_buildMode0Math },
+   { "mode3_8bpp", &_buildMode3 },
+   { "mode3_direct", &_buildMode3Direct },
+   { "mode7_rotate", &_buildMode7 },
+   { "mode1_windows", &_buildMode1Windows },
+   { "mode1_mosaic", &_buildMode1Mosaic },
+   { "mode1_wavy", &_buildMode1Wavy },
+   { "mode2_columns", &_buildMode2Columns },
+   { "mode5_hires", &_buildMode5Hires }
+};
+
+static void _copyPalettes(DB_DBAssets *db, int64_t characterMapId, SNESColor *dest, int paletteOffset) {
+   vec(DBCharacterEncodePalette) *pals = dbCharacterEncodePaletteSelectBycharacterMapId(db, characterMapId);
+   vecForEach(DBCharacterEncodePalette, p, pals, {
+      DBPalettes dbp = dbPalettesSelectFirstByid(db, p->paletteId);
+      memcpy(dest + (p->index + paletteOffset) * 16, dbp.colors, dbp.colorsSize);
+      dbPalettesDestroy(&dbp);
+   });
+   vecDestroy(DBCharacterEncodePalette)(pals);
+}
+
+// Mirrors _setupTestSNES and the sprite placement from gameUpdate
+static boolean _buildDBScene(SNES *snes, const char *dbPath) {
+   DB_DBAssets *db = db_DBAssetsCreate();
+   CMap *hmap = NULL, *map = NULL, *map2 = NULL;
+   CMapBlock *hblock = NULL, *block = NULL, *block2 = NULL;
+   int i = 0;
+
+   if (dbConnect((DBBase*)db, dbPath, false) != DB_SUCCESS) {
+      printf("Failed to open %s: %s\n", dbPath, dbGetError(db));
+      db_DBAssetsDestroy(db);
+      return false;
+   }
+
+   snes->reg.bgMode.mode = 1;
+   snes->reg.bgMode.m1bg3pri = 1;
+   snes->reg.bgSizeAndTileBase[0].baseAddr = 0;
+   snes->reg.bgSizeAndTileBase[1].baseAddr = 4;
+   snes->reg.bgSizeAndTileBase[2].baseAddr = 31;
+   snes->reg.objSizeAndBase.baseAddr = 1;
+   snes->reg.objSizeAndBase.objSize = OBJSIZE_32x32_64x64;
+   snes->reg.bgCharBase.bg1 = 4;
+   snes->reg.bgCharBase.bg2 = 4;
+   snes->reg.bgCharBase.bg3 = 4;
+   snes->reg.colorMathControl.enableBGOBJ = 1;
+   snes->reg.colorMathControl.bg1 = 1;
+   snes->reg.mainScreenDesignation.bg1 = 1;
+   snes->reg.mainScreenDesignation.bg3 = 1;
+   snes->reg.subScreenDesignation.obj = 1;
+   snes->reg.mosaic.enableBG1 = 1;
+
+   DBCharacterMaps hades = dbCharacterMapsSelectFirstByid(db, 25);
+   hmap = cMapCreate(snes, 2, 2, 32);
+   hblock = cMapAlloc(hmap, 4, (byte2)hades.width, (byte2)hades.height, 8, 8);
+   cMapBlockSetCharacters(hblock, hades.data);
+   cMapCommit(hmap, NULL);
+   _copyPalettes(db, hades.id, snes->cgram.objPalettes.palette16s[0].colors, 0);
+   memcpy(&snes->cgram.objPalettes.palette16s[1], &snes->cgram.objPalettes.palette16s[0], sizeof(snes->cgram.objPalettes.palette16s[0]));
+
+   for (i = 0; i < 4; ++i) {
+      TwosComplement9 sx = { .raw = 28 + (i % 2) * 64 };
+      Sprite *s = &snes->oam.primary[i];
+
+      s->character = cMapBlockGetCharacter(hblock, 0, 0);
+      s->x = sx.twos.value;
+      s->y = (byte)(58 + (i / 2) * 64);
+      s->priority = 3;
+      s->palette = 1;
+      s->flipX = i % 2;
+      s->flipY = i / 2;
+   }
+   snes->oam.secondary[0].sz_0 = snes->oam.secondary[0].sz_1 = 1;
+   snes->oam.secondary[0].sz_2 = snes->oam.secondary[0].sz_3 = 1;
+
+   DBCharacterMaps bg = dbCharacterMapsSelectFirstByid(db, 29);
+   map = cMapCreate(snes, 4, 4, 60);
+   block = cMapAlloc(map, 4, 30, 19, 8, 8);
+   cMapBlockSetCharacters(block, bg.data);
+   cMapCommit(map, NULL);
+
+   CMapTileAttributes bgAttributes = { .palettes = bg.tilePaletteMap, .priority = 1 };
+   cMapBlockFillTileMap(block, snes->vram.mode1.bg1TMaps, false, false, 0, 0, 0, 0, bg.width, bg.height, &bgAttributes);
+
+   DBCharacterMaps txt = dbCharacterMapsSelectFirstByid(db, 28);
+   map2 = cMapCreate(snes, 4, 0, 4);
+   cMapAlloc(map2, 2, 1, 1, 8, 8);
+   block2 = cMapAlloc(map2, 2, 16, 4, 8, 8);
+   cMapBlockSetCharacters(block2, txt.data);
+   cMapCommit(map2, NULL);
+
+   CMapTileAttributes txtAttributes = { .palette = 3, .priority = 1 };
+   cMapBlockFillTileMap(block2, &snes->vram.mode1.bg3TMap, false, false, 0, 0, 0, 0, txt.width, 4, &txtAttributes);
+
+   _copyPalettes(db, bg.id, snes->cgram.bgPalette16s[0].colors, 0);
+   _copyPalettes(db, txt.id, snes->cgram.bgPalette16s[0].colors, 3);
+
+   cMapDestroy(hmap);
+   cMapDestroy(map);
+   cMapDestroy(map2);
+   dbCharacterMapsDestroy(&hades);
+   dbCharacterMapsDestroy(&bg);
+   dbCharacterMapsDestroy(&txt);
+
+   db_DBAssetsDestroy(db);
+   return true;
+}
+
+// Scrolls every layer and sprite a little each frame so the renderer can't skip unchanged work
+static void _animate(SNES *snes, int frame) {
+   int i = 0;
+
+   if (snes->reg.bgMode.mode == 7) {
+      snes->reg.bgScroll[0].M7.horzOffset.raw = (sbyte2)(frame & 0xFFF);
+   }
+   else {
+      for (i = 0; i < 4; ++i) {
+         snes->reg.bgScroll[i].BG.horzOffset = (byte2)(frame + i);
+         snes->reg.bgScroll[i].BG.vertOffset = (byte2)(frame >> 1);
+      }
+   }
+
+   for (i = 0; i < 128; ++i) {
+      ++snes->oam.primary[i].x;
+   }
+}
+
+static int _compareU64(const void *a, const void *b) {
+   uint64_t l = *(const uint64_t*)a, r = *(const uint64_t*)b;
+   return (l > r) - (l < r);
+}
+
+// nearest-rank percentile of a sorted list
+static uint64_t _percentile(const uint64_t *sorted, int count, int pct) {
+   int rank = (count * pct + 99) / 100;
+   return sorted[MAX(rank, 1) - 1];
+}
+
+static void _runScene(Scene *scene, const BenchOptions *opts, ColorRGBA *rgba, byte2 *indices, byte *flags) {
+   uint64_t *times = checkedCalloc(opts->frames, sizeof(uint64_t));
+   SNESRenderer *renderer = snesRendererCreate();
+   uint64_t fMin = 0, fMed = 0, fP99 = 0;
+   int i = 0;
+
+   // the first frames decode all of vram and build the palette cache
+   for (i = 0; i < WARMUP_FRAME_COUNT; ++i) {
+      if (opts->indexed) {
+         snesRenderIndexed(scene->snes, renderer, indices, flags, opts->renderFlags);
+      }
+      else {
+         snesRender(scene->snes, renderer, rgba, opts->renderFlags);
+      }
+   }
+
+   for (i = 0; i < opts->frames; ++i) {
+      uint64_t start = 0;
+
+      if (opts->animate) {
+         _animate(scene->snes, i);
+      }
+
+      start = _nowNs();
+      if (opts->indexed) {
+         snesRenderIndexed(scene->snes, renderer, indices, flags, opts->renderFlags);
+      }
+      else {
+         snesRender(scene->snes, renderer, rgba, opts->renderFlags);
+      }
+      times[i] = _nowNs() - start;
+   }
+
+   qsort(times, opts->frames, sizeof(uint64_t), &_compareU64);
+   fMin = times[0];
+   fMed = _percentile(times, opts->frames, 50);
+   fP99 = _percentile(times, opts->frames, 99);
+
+   // lines aren't timed on their own, the line columns are each frame time spread evenly over its scanlines
+   printf("%-20s %10llu %10llu %10llu %8llu %8llu %8llu\n", scene->name,
+      (unsigned long long)fMin, (unsigned long long)fMed, (unsigned long long)fP99,
+      (unsigned long long)(fMin / SNES_SCANLINE_COUNT),
+      (unsigned long long)(fMed / SNES_SCANLINE_COUNT),
+      (unsigned long long)(fP99 / SNES_SCANLINE_COUNT));
+
+   snesRendererDestroy(renderer);
+   checkedFree(times);
+}
+
+// path without its directories
+static const char *_fileName(const char *path) {
+   const char *out = path;
+   for (; *path; ++path) {
+      if (*path == '/' || *path == '\\') {
+         out = path + 1;
+      }
+   }
+   return out;
+}
+
+static Scene *_addScene(Scene *scenes, int *count, const char *name) {
+   Scene *s = NULL;
+
+   if (*count >= MAX_SCENES) {
+      printf("Too many scenes, skipping %s\n", name);
+      return NULL;
+   }
+
+   s = &scenes[(*count)++];
+   snprintf(s->name, sizeof(s->name), "%s", name);
+   s->snes = checkedCalloc(1, sizeof(SNES));
+   return s;
+}
+
+// Hires lines with nothing drawn on either screen, both halves of every pixel pair have to be the backdrop
+// cgram 0 is made a color of its own so showing it in place of the backdrop can't pass
+static boolean _checkHiresBackdrop() {
+   static SNES snes;
+   static ColorRGBA rgba[SNES_SCANLINE_WIDTH * SNES_SCANLINE_COUNT];
+   static byte2 indices[SNES_SIZE_X * SNES_SCANLINE_COUNT];
+   static byte flags[SNES_SIZE_X * SNES_SCANLINE_COUNT];
+   SNESRenderer *renderer = snesRendererCreate();
+   boolean pass = true;
+   int pseudo = 0, white = 0, i = 0;
+
+   for (pseudo = 0; pseudo < 2; ++pseudo) {
+      for (white = 0; white < 2; ++white) {
+         int renderFlags = white ? SNES_RENDER_DEBUG_WHITE : 0;
+         byte wantFlags = SNES_INDEXED_BACKDROP | SNES_INDEXED_HIRES | (white ? SNES_INDEXED_BACKDROP_WHITE : 0);
+         int badPairs = 0, badIndexed = 0;
+
+         memset(&snes, 0, sizeof(snes));
+         snes.cgram.colors[0] = (SNESColor) { 12, 20, 4 };
+         snes.reg.bgMode.mode = pseudo ? 1 : 5;
+         snes.reg.screenSettings.pseudoHiResMode = pseudo;
+
+         snesRender(&snes, renderer, rgba, renderFlags);
+         for (i = 0; i < SNES_SCANLINE_WIDTH * SNES_SCANLINE_COUNT; i += 2) {
+            ColorRGBA want = white ? (ColorRGBA) { 255, 255, 255, 255 } : (ColorRGBA) { 0, 0, 0, 255 };
+            if (memcmp(&rgba[i], &want, sizeof(want)) || memcmp(&rgba[i + 1], &want, sizeof(want))) {
+               ++badPairs;
+            }
+         }
+
+         snesRenderIndexed(&snes, renderer, indices, flags, renderFlags);
+         for (i = 0; i < SNES_SIZE_X * SNES_SCANLINE_COUNT; ++i) {
+            if ((indices[i] >> 8) || flags[i] != wantFlags) {
+               ++badIndexed;
+            }
+         }
+
+         if (badPairs || badIndexed) {
+            printf("hires backdrop (%s, %s): %d pixel pairs and %d indexed pixels aren't the backdrop\n",
+               pseudo ? "pseudo hires mode 1" : "mode 5", white ? "white" : "black", badPairs, badIndexed);
+            pass = false;
+         }
+      }
+   }
+
+   snesRendererDestroy(renderer);
+   return pass;
+}
+
+// Every builtin scene rendered serially and split across CHECK_THREAD_COUNT threads for a few animated frames
+// both outputs have to match byte for byte, frames after the first only redraw the lines the cache lets through
+static boolean _checkThreads() {
+   static SNES scenes[2];
+   static ColorRGBA rgba[2][SNES_SCANLINE_WIDTH * SNES_SCANLINE_COUNT];
+   static byte2 indices[2][SNES_SIZE_X * SNES_SCANLINE_COUNT];
+   static byte flags[2][SNES_SIZE_X * SNES_SCANLINE_COUNT];
+   SNESRenderer *renderers[4];
+   int threads = snesRenderGetThreadCount();
+   boolean pass = true;
+   int i = 0, t = 0, frame = 0;
+
+   for (i = 0; i < LEN(g_builtins); ++i) {
+      _rngSeed(i + 1);
+      memset(&scenes[0], 0, sizeof(SNES));
+      g_builtins[i].build(&scenes[0]);
+      scenes[1] = scenes[0];
+
+      for (t = 0; t < 4; ++t) {
+         renderers[t] = snesRendererCreate();
+      }
+
+      for (frame = 0; frame < CHECK_FRAME_COUNT; ++frame) {
+         for (t = 0; t < 2; ++t) {
+            _animate(&scenes[t], frame);
+            snesRenderSetThreadCount(t ? CHECK_THREAD_COUNT : 1);
+            snesRender(&scenes[t], renderers[t], rgba[t], 0);
+            snesRenderIndexed(&scenes[t], renderers[2 + t], indices[t], flags[t], 0);
+         }
+
+         if (memcmp(rgba[0], rgba[1], sizeof(rgba[0])) || memcmp(indices[0], indices[1], sizeof(indices[0])) ||
+            memcmp(flags[0], flags[1], sizeof(flags[0]))) {
+            printf("threads (%s, frame %d): %d threads don't match 1\n", g_builtins[i].name, frame, CHECK_THREAD_COUNT);
+            pass = false;
+            break;
+         }
+      }
+
+      for (t = 0; t < 4; ++t) {
+         snesRendererDestroy(renderers[t]);
+      }
+   }
+
+   snesRenderSetThreadCount(threads);
+   return pass;
+}
+
+// Every builtin scene through the SIMD line loops and the scalar ones for a few animated frames
+// both outputs have to match byte for byte, cpus without SIMD loops only have the one path to run
+static boolean _checkSIMD() {
+   static SNES scenes[2];
+   static ColorRGBA rgba[2][SNES_SCANLINE_WIDTH * SNES_SCANLINE_COUNT];
+   static byte2 indices[2][SNES_SIZE_X * SNES_SCANLINE_COUNT];
+   static byte flags[2][SNES_SIZE_X * SNES_SCANLINE_COUNT];
+   SNESRenderer *renderers[4];
+   boolean pass = true;
+   int i = 0, t = 0, frame = 0;
+
+   snesRenderSetSIMD(true);
+   if (!snesRenderGetSIMD()) {
+      printf("simd: no SIMD line loops on this cpu, nothing to compare\n");
+      return true;
+   }
+
+   for (i = 0; i < LEN(g_builtins); ++i) {
+      _rngSeed(i + 1);
+      memset(&scenes[0], 0, sizeof(SNES));
+      g_builtins[i].build(&scenes[0]);
+      scenes[1] = scenes[0];
+
+      for (t = 0; t < 4; ++t) {
+         renderers[t] = snesRendererCreate();
+      }
+
+      for (frame = 0; frame < CHECK_FRAME_COUNT; ++frame) {
+         for (t = 0; t < 2; ++t) {
+            _animate(&scenes[t], frame);
+            snesRenderSetSIMD(!t);
+            snesRender(&scenes[t], renderers[t], rgba[t], 0);
+            snesRenderIndexed(&scenes[t], renderers[2 + t], indices[t], flags[t], 0);
+         }
+
+         if (memcmp(rgba[0], rgba[1], sizeof(rgba[0])) || memcmp(indices[0], indices[1], sizeof(indices[0])) ||
+            memcmp(flags[0], flags[1], sizeof(flags[0]))) {
+            printf("simd (%s, frame %d): SIMD line loops don't match the scalar ones\n", g_builtins[i].name, frame);
+            pass = false;
+            break;
+         }
+      }
+
+      for (t = 0; t < 4; ++t) {
+         snesRendererDestroy(renderers[t]);
+      }
+   }
+
+   snesRenderSetSIMD(true);
+   return pass;
+}
+
+// Makes one small change a frame, cycling through vram, cgram, oam, latches and then a quiet frame
+// each change leaves most lines as they were so the line cache gets to skip them
+static void _mutate(SNES *snes, int frame) {
+   Registers regs;
+   int y = 0;
+
+   switch (frame % 5) {
+   case 0: {
+      //one of BG1's tiles and a few bytes of its first characters, anywhere else in vram could go unseen
+      byte *tiles = snes->vram.raw + (snes->reg.bgSizeAndTileBase[0].baseAddr << 11);
+      byte *chars = snes->vram.raw + (snes->reg.bgCharBase.bg1 << 13);
+      int i = 0;
+      tiles[_rng() % sizeof(TileMap)] = (byte)_rng();
+      for (i = 0; i < 4; ++i) {
+         chars[_rng() % 4096] = (byte)_rng();
+      }
+      break;
+   }
+   case 1:
+      ((byte2*)&snes->cgram)[_rng() & 255] = (byte2)(_rng() & 0x7FFF);
+      break;
+   case 2: {
+      Sprite *spr = &snes->oam.primary[_rng() & 127];
+      spr->y = (byte)(_rng() % SNES_SCANLINE_COUNT);
+      spr->character = (byte)_rng();
+      break;
+   }
+   case 3:
+      //a scroll gradient over the bottom of the screen, starting somewhere new every time
+      snesLatchClear(snes);
+      regs = snes->reg;
+      for (y = (int)(_rng() % SNES_SCANLINE_COUNT); y < SNES_SCANLINE_COUNT; y += 8) {
+         regs.bgScroll[0].BG.horzOffset += 3;
+         snesLatchRegisters(snes, y, &regs);
+      }
+      break;
+   }
+}
+
+// Every builtin scene changed a little each frame and rendered through a renderer that carries its caches
+// over, each frame has to match the same frame rendered through a brand new renderer that caches nothing
+static boolean _checkLineCache() {
+   static SNES snes;
+   static ColorRGBA rgba[2][SNES_SCANLINE_WIDTH * SNES_SCANLINE_COUNT];
+   static byte2 indices[2][SNES_SIZE_X * SNES_SCANLINE_COUNT];
+   static byte flags[2][SNES_SIZE_X * SNES_SCANLINE_COUNT];
+   SNESRenderer *cached[2];
+   boolean pass = true;
+   int i = 0, frame = 0, skipped = 0;
+
+   for (i = 0; i < LEN(g_builtins); ++i) {
+      _rngSeed(i + 1);
+      memset(&snes, 0, sizeof(SNES));
+      g_builtins[i].build(&snes);
+
+      cached[0] = snesRendererCreate();
+      cached[1] = snesRendererCreate();
+
+      for (frame = 0; frame < CHECK_CACHE_FRAME_COUNT; ++frame) {
+         SNESRenderer *fresh = snesRendererCreate();
+
+         _mutate(&snes, frame);
+         snesRender(&snes, cached[0], rgba[0], 0);
+         snesRenderIndexed(&snes, cached[1], indices[0], flags[0], 0);
+         skipped += SNES_SCANLINE_COUNT - (cached[0]->lineCache.dirtyBottom - cached[0]->lineCache.dirtyTop);
+
+         snesRender(&snes, fresh, rgba[1], 0);
+         snesRenderIndexed(&snes, fresh, indices[1], flags[1], 0);
+         snesRendererDestroy(fresh);
+
+         if (memcmp(rgba[0], rgba[1], sizeof(rgba[0])) || memcmp(indices[0], indices[1], sizeof(indices[0])) ||
+            memcmp(flags[0], flags[1], sizeof(flags[0]))) {
+            printf("line cache (%s, frame %d): cached render doesn't match a fresh one\n", g_builtins[i].name, frame);
+            pass = false;
+            break;
+         }
+      }
+
+      snesRendererDestroy(cached[0]);
+      snesRendererDestroy(cached[1]);
+   }
+
+   //if nothing was ever skipped the check above compared two full redraws and proved nothing about the cache
+   if (!skipped) {
+      printf("line cache: no frame skipped a line\n");
+      pass = false;
+   }
+
+   return pass;
+}
+
+// Counts the tiles of a block that aren't in vram where the PPU looks for them, the tile's character for the
+// top left 8x8, + 1 for the right half and + 16 for the bottom, counted in characters of the block's depth
+static int _cMapBadTiles(SNES *snes, byte baseAddr, const CheckBlock *b) {
+   const Char4 *vram = (const Char4*)(snes->vram.raw + (baseAddr << 13));
+   int charSize = b->depth >> 1, partsX = b->tileWidth >> 3, partsY = b->tileHeight >> 3;
+   int stride = b->width * partsX * charSize;
+   int x = 0, y = 0, px = 0, py = 0, bad = 0;
+
+   for (y = 0; y < b->height; ++y) {
+      for (x = 0; x < b->width; ++x) {
+         int c = cMapBlockGetCharacter(b->block, (byte2)x, (byte2)y);
+         boolean match = true;
+
+         for (py = 0; py < partsY; ++py) {
+            for (px = 0; px < partsX; ++px) {
+               const Char4 *want = b->data + (y * partsY + py) * stride + (x * partsX + px) * charSize;
+               const Char4 *got = vram + (c + px + py * 16) * charSize;
+               match &= !memcmp(want, got, charSize * sizeof(Char4));
+            }
+         }
+
+         bad += !match;
+      }
+   }
+
+   return bad;
+}
+
+static void _cMapSnapshot(CheckBlock *b) {
+   int x = 0, y = 0;
+   for (y = 0; y < b->height; ++y) {
+      for (x = 0; x < b->width; ++x) {
+         b->characters[y * b->width + x] = cMapBlockGetCharacter(b->block, (byte2)x, (byte2)y);
+      }
+   }
+}
+
+// Whether every tile of a block is where its snapshotted character goes by the moves, or still there if none covers it
+static boolean _cMapMovesMatch(const CheckBlock *b, vec(CMapMove) *moves) {
+   int x = 0, y = 0;
+   for (y = 0; y < b->height; ++y) {
+      for (x = 0; x < b->width; ++x) {
+         byte2 old = b->characters[y * b->width + x], want = old;
+         vecForEach(CMapMove, m, moves, {
+            if (m->block == b->block && old >= m->from && old < m->from + m->count) {
+               want = m->to + (old - m->from);
+               break;
+            }
+         });
+
+         if (cMapBlockGetCharacter(b->block, (byte2)x, (byte2)y) != want) {
+            return false;
+         }
+      }
+   }
+   return true;
+}
+
+// Allocates the block b describes and gives it random characters, false if it doesn't fit
+static boolean _cMapCheckAlloc(CMap *cmap, CheckBlock *b) {
+   int size = b->width * (b->tileWidth >> 3) * (b->depth >> 1) * b->height * (b->tileHeight >> 3);
+   int i = 0;
+
+   b->block = cMapAlloc(cmap, b->depth, b->width, b->height, b->tileWidth, b->tileHeight);
+   if (!b->block) {
+      return false;
+   }
+
+   b->data = checkedMalloc(size * sizeof(Char4));
+   for (i = 0; i < size * (int)sizeof(Char4); ++i) {
+      ((byte*)b->data)[i] = (byte)_rng();
+   }
+   b->characters = checkedCalloc(b->width * b->height, sizeof(byte2));
+   cMapBlockSetCharacters(b->block, b->data);
+   return true;
+}
+
+static void _cMapCheckFree(CMap *cmap, CheckBlock *b) {
+   cMapFree(cmap, b->block);
+   checkedFree(b->data);
+   checkedFree(b->characters);
+}
+
+// Defrags and checks the moves against where every block's characters went, a defrag that rolls
+// back has to report no moves and leave every character where it was.  Returns what went wrong or NULL
+static const char *_cMapCheckDefrag(CMap *cmap, CheckBlock *blocks, int count, vec(CMapMove) *moves, boolean *packed) {
+   const char *failure = NULL;
+   int i = 0;
+
+   for (i = 0; i < count; ++i) {
+      _cMapSnapshot(blocks + i);
+   }
+
+   cMapClearMoves(cmap);
+   *packed = cMapDefrag(cmap);
+   vecClear(CMapMove)(moves);
+   cMapGetMoves(cmap, moves);
+
+   if (!*packed && !vecIsEmpty(CMapMove)(moves)) {
+      failure = "a defrag that rolled back reported moves";
+   }
+   for (i = 0; i < count && !failure; ++i) {
+      if (!_cMapMovesMatch(blocks + i, moves)) {
+         failure = *packed ? "a defrag's moves don't match where characters went" : "a defrag that rolled back moved blocks";
+      }
+   }
+
+   cMapClearMoves(cmap);
+   return failure;
+}
+
+// Commits and counts the tiles of every block that aren't in vram where their characters say
+static int _cMapCheckCommit(SNES *snes, CMap *cmap, const CheckBlock *blocks, int count) {
+   int i = 0, bad = 0;
+   cMapCommit(cmap, NULL);
+   for (i = 0; i < count; ++i) {
+      bad += _cMapBadTiles(snes, 0, blocks + i);
+   }
+   return bad;
+}
+
+// A small cmap churned with blocks of every depth and tile size until it fragments, allocs that don't fit
+// defrag and try again.  After every step each block's tiles have to be in vram where the PPU reads them,
+// a failed alloc must move nothing and a defrag's moves have to account for every character that changed.
+// Random churn always packs, so a one row layout that can't be packed widest first covers the rollback
+static boolean _checkCMap() {
+   static SNES snes;
+   static const byte depths[] = { 2, 4, 8 };
+   CheckBlock blocks[CHECK_CMAP_BLOCKS];
+   vec(CMapMove) *moves = vecCreate(CMapMove)(NULL);
+   CMap *cmap = NULL;
+   int count = 0, step = 0, i = 0, full = 0;
+   boolean packed = false;
+   const char *failure = NULL;
+
+   memset(&snes, 0, sizeof(SNES));
+   _rngSeed(1);
+   cmap = cMapCreate(&snes, 0, 0, 16);
+
+   for (step = 0; step < CHECK_CMAP_STEPS && !failure; ++step) {
+      if (count == CHECK_CMAP_BLOCKS || (count && _rng() % 2)) {
+         CheckBlock *b = blocks + _rng() % count;
+         _cMapCheckFree(cmap, b);
+         *b = blocks[--count];
+      }
+      else {
+         CheckBlock *b = blocks + count;
+
+         //16 wide tiles are 16x16 or the 16x8 hires ones, cMapAlloc only takes 16 tall ones in 16 colors
+         b->depth = depths[_rng() % LEN(depths)];
+         b->tileWidth = _rng() % 2 ? 16 : 8;
+         b->tileHeight = b->tileWidth == 16 && b->depth == 4 && _rng() % 2 ? 16 : 8;
+         b->width = (byte2)(1 + _rng() % (48 / ((b->tileWidth >> 3) * (b->depth >> 1))));
+         b->height = (byte2)(1 + _rng() % (32 / b->tileHeight));
+
+         for (i = 0; i < count; ++i) {
+            _cMapSnapshot(blocks + i);
+         }
+
+         if (!_cMapCheckAlloc(cmap, b)) {
+            ++full;
+            vecClear(CMapMove)(moves);
+            cMapGetMoves(cmap, moves);
+            for (i = 0; i < count && !failure; ++i) {
+               if (!vecIsEmpty(CMapMove)(moves) || !_cMapMovesMatch(blocks + i, moves)) {
+                  failure = "an alloc that didn't fit moved blocks";
+               }
+            }
+
+            if (!failure) {
+               failure = _cMapCheckDefrag(cmap, blocks, count, moves, &packed);
+            }
+            if (!failure && !packed) {
+               failure = "a defrag of random blocks rolled back";
+            }
+         }
+
+         //the alloc that failed is tried once more after the defrag
+         if (b->block || _cMapCheckAlloc(cmap, b)) {
+            ++count;
+         }
+      }
+
+      if (!failure && _cMapCheckCommit(&snes, cmap, blocks, count)) {
+         failure = "tiles aren't in vram where their characters say";
+      }
+   }
+
+   if (failure) {
+      printf("cmap (step %d): %s\n", step - 1, failure);
+   }
+   else if (!full) {
+      printf("cmap: every alloc fit so nothing was defragged\n");
+      failure = "";
+   }
+
+   while (count) {
+      _cMapCheckFree(cmap, blocks + --count);
+   }
+   cMapDestroy(cmap);
+
+   //30 of a row's 32 columns as 8, 8, 5 and 9 wide blocks, packing widest first puts the 9 at the left
+   //and the 16 color block's 8 after it, which pushes the 256 color one to 20 and leaves 4 columns for the 5
+   if (!failure) {
+      static const CheckBlock tight[] = {
+         { NULL, 4, 8, 8, 4, 1 }, { NULL, 8, 8, 8, 2, 1 }, { NULL, 2, 8, 8, 5, 1 }, { NULL, 2, 8, 8, 9, 1 }
+      };
+
+      cmap = cMapCreate(&snes, 0, 0, 1);
+      for (count = 0; count < LEN(tight) && !failure; ++count) {
+         blocks[count] = tight[count];
+         if (!_cMapCheckAlloc(cmap, blocks + count)) {
+            failure = "the tight layout doesn't fit";
+         }
+      }
+
+      if (!failure) {
+         failure = _cMapCheckDefrag(cmap, blocks, count, moves, &packed);
+      }
+      if (!failure && packed) {
+         failure = "the tight layout packed, it no longer covers the rollback";
+      }
+      if (!failure && _cMapCheckCommit(&snes, cmap, blocks, count)) {
+         failure = "tiles aren't in vram where their characters say after a rollback";
+      }
+
+      if (failure) {
+         printf("cmap (tight row): %s\n", failure);
+      }
+
+      //a block that didn't fit has nothing to free
+      while (count) {
+         if (blocks[--count].block) {
+            _cMapCheckFree(cmap, blocks + count);
+         }
+      }
+      cMapDestroy(cmap);
+   }
+
+   vecDestroy(CMapMove)(moves);
+   return !failure;
+}
+
+// Renderer correctness checks, -c runs them instead of the benchmark
+static int _runChecks() {
+   int failed = 0;
+   failed += !_checkHiresBackdrop();
+   failed += !_checkThreads();
+   failed += !_checkSIMD();
+   failed += !_checkLineCache();
+   failed += !_checkCMap();
+
+   printf("%s\n", failed ? "checks failed" : "checks passed");
+   printMemoryLeaks();
+   return failed ? 1 : 0;
+}
+
+static void _showHelp() {
+   printf("Usage: snesbench [options] [state files...]\n");
+   printf("   -n <frames>   frames timed per scene (default %d)\n", DEFAULT_FRAME_COUNT);
+   printf("   -t <threads>  render threads (default 1)\n");
+   printf("   -i            time snesRenderIndexed instead of snesRender\n");
+   printf("   -s            static scenes, nothing changes between frames\n");
+   printf("   -f            redraw every line, even the ones the line cache would skip\n");
+   printf("   -x            skip the built-in synthetic scenes\n");
+   printf("   -db <file>    add the test scene built from snesquest.db character maps\n");
+   printf("   -save <dir>   write every scene to <dir>/<name>.snes before timing\n");
+   printf("   -c            run the renderer checks instead of timing anything\n");
+}
+
+int main(int argc, char *argv[]) {
+   BenchOptions opts = { DEFAULT_FRAME_COUNT, 1, false, true, true, NULL, NULL, 0 };
+   static Scene scenes[MAX_SCENES];
+   int sceneCount = 0;
+   int i = 0;
+
+   for (i = 1; i < argc; ++i) {
+      const char *arg = argv[i];
+      boolean hasValue = i + 1 < argc;
+
+      if (!strcmp(arg, "-n") && hasValue) {
+         opts.frames = atoi(argv[++i]);
+         opts.frames = MAX(1, opts.frames);
+      }
+      else if (!strcmp(arg, "-t") && hasValue) {
+         opts.threads = atoi(argv[++i]);
+      }
+      else if (!strcmp(arg, "-i")) {
+         opts.indexed = true;
+      }
+      else if (!strcmp(arg, "-s")) {
+         opts.animate = false;
+      }
+      else if (!strcmp(arg, "-f")) {
+         opts.renderFlags |= SNES_RENDER_FULL;
+      }
+      else if (!strcmp(arg, "-x")) {
+         opts.builtins = false;
+      }
+      else if (!strcmp(arg, "-db") && hasValue) {
+         opts.dbPath = argv[++i];
+      }
+      else if (!strcmp(arg, "-save") && hasValue) {
+         opts.saveDir = argv[++i];
+      }
+      else if (!strcmp(arg, "-c")) {
+         return _runChecks();
+      }
+      else if (arg[0] == '-') {
+         _showHelp();
+         return 1;
+      }
+      else {
+         Scene *s = _addScene(scenes, &sceneCount, _fileName(arg));
+         if (s && !snesLoadState(s->snes, arg)) {
+            printf("Failed to load state %s\n", arg);
+            checkedFree(s->snes);
+            --sceneCount;
+         }
+      }
+   }
+
+   if (opts.builtins) {
+      for (i = 0; i < sizeof(g_builtins) / sizeof(g_builtins[0]); ++i) {
+         Scene *s = _addScene(scenes, &sceneCount, g_builtins[i].name);
+         if (s) {
+            _rngSeed(i + 1);
+            g_builtins[i].build(s->snes);
+         }
+      }
+   }
+
+   if (opts.dbPath) {
+      Scene *s = _addScene(scenes, &sceneCount, "db_test");
+      if (s && !_buildDBScene(s->snes, opts.dbPath)) {
+         checkedFree(s->snes);
+         --sceneCount;
+      }
+   }
+
+   if (!sceneCount) {
+      _showHelp();
+      return 1;
+   }
+
+   if (opts.saveDir) {
+      for (i = 0; i < sceneCount; ++i) {
+         char path[512];
+         int length = snprintf(path, sizeof(path), "%s/%s.snes", opts.saveDir, scenes[i].name);
+         if (length < 0 || length >= (int)sizeof(path)) {
+            printf("Save path too long for %s\n", scenes[i].name);
+         }
+         else if (!snesSaveState(scenes[i].snes, path)) {
+            printf("Failed to save %s\n", path);
+         }
+      }
+   }
+
+   ColorRGBA *rgba = checkedCalloc(SNES_SCANLINE_WIDTH * SNES_SCANLINE_COUNT, sizeof(ColorRGBA));
+   byte2 *indices = checkedCalloc(SNES_SIZE_X * SNES_SIZE_Y, sizeof(byte2));
+   byte *flags = checkedCalloc(SNES_SIZE_X * SNES_SIZE_Y, sizeof(byte));
+
+   snesRenderSetThreadCount(opts.threads);
+
+   printf("%d frames per scene, %d thread(s), %s output, %s%s\n", opts.frames, snesRenderGetThreadCount(),
+      opts.indexed ? "indexed" : "rgba", opts.animate ? "animated" : "static",
+      (opts.renderFlags & SNES_RENDER_FULL) ? ", full redraw" : "");
+   printf("%-20s %10s %10s %10s  ns per line, frame / %d\n", "", "frame ns", "", "", SNES_SCANLINE_COUNT);
+   printf("%-20s %10s %10s %10s %8s %8s %8s\n", "scene", "min", "median", "p99", "min", "median", "p99");
+
+   for (i = 0; i < sceneCount; ++i) {
+      _runScene(&scenes[i], &opts, rgba, indices, flags);
+      checkedFree(scenes[i].snes);
+   }
+
+   snesRenderSetThreadCount(0);
+   checkedFree(rgba);
+   checkedFree(indices);
+   checkedFree(flags);
+
+   printMemoryLeaks();
+   return 0;
+}
@@ -12,12 +12,64 @@ uniform sampler2D uTexture;
 in vec2 vTexCoords;
 #endif
 
+#ifdef SNES_PALETTE
+//resolves the planes from snesRenderIndexed against cgram, must match snesRender exactly
+uniform usampler2D uSnesIndices;
+uniform usampler2D uSnesFlags;
+uniform usampler2D uSnesPalette;
+
+uvec3 snesPaletteColor(uint index){
+   uint c = texelFetch(uSnesPalette, ivec2(int(index), 0), 0).r;
+   return uvec3(c & 31u, (c >> 5) & 31u, (c >> 10) & 31u);
+}
+
+vec4 snesResolve(ivec2 pixel){
+   //target is 512 wide like snesRender, every snes pixel is doubled
+   ivec2 snesPixel = ivec2(pixel.x / 2, pixel.y);
+   uint indices = texelFetch(uSnesIndices, snesPixel, 0).r;
+   uint flags = texelFetch(uSnesFlags, snesPixel, 0).r;
+
+   //SNES_INDEXED_HIRES, the left half of the pair shows the sub screen
+   //a transparent sub screen shows the backdrop, SNES_INDEXED_BACKDROP_WHITE is set on hires pixels for it
+   if((flags & 32u) != 0u && (pixel.x & 1) == 0){
+      if((indices >> 8) == 0u){
+         return (flags & 16u) != 0u ? vec4(1.0) : vec4(0.0, 0.0, 0.0, 1.0);
+      }
+      uvec3 sub = snesPaletteColor(indices >> 8);
+      return vec4(vec3((sub << 3) | (sub >> 2)) / 255.0, 1.0);
+   }
+
+   //SNES_INDEXED_BACKDROP, SNES_INDEXED_BACKDROP_WHITE
+   if((flags & 8u) != 0u){
+      return (flags & 16u) != 0u ? vec4(1.0) : vec4(0.0, 0.0, 0.0, 1.0);
+   }
+
+   uvec3 color = snesPaletteColor(indices & 255u);
+
+   //SNES_INDEXED_COLOR_MATH, SNES_INDEXED_SUBTRACT, SNES_INDEXED_HALVE
+   //byte math like the cpu path so subtraction underflow wraps and clamps to 31
+   if((flags & 1u) != 0u){
+      //SNES_INDEXED_MATH_BACKDROP
+      uvec3 sub = snesPaletteColor((flags & 64u) != 0u ? 0u : indices >> 8);
+      color = (flags & 2u) != 0u ? color - sub : color + sub;
+      color = (color & 255u) >> ((flags & 4u) != 0u ? 1u : 0u);
+      color = min(color, uvec3(31u));
+   }
+
+   return vec4(vec3((color << 3) | (color >> 2)) / 255.0, 1.0);
+}
+#endif
+
 void main(){
    vec4 color = vColor;
 
    #ifdef DIFFUSE_TEXTURE
    color *= texture(uTexture, vTexCoords);
    #endif
+
+   #ifdef SNES_PALETTE
+   color *= snesResolve(ivec2(gl_FragCoord.xy));
+   #endif
       
    outColor = color;
 }